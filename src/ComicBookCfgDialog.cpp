@@ -43,7 +43,7 @@ ComicBookCfgDialog::ComicBookCfgDialog(QWidget *parent, ComicBookSettings *cfg):
     cb_hidestatus->setChecked(cfg->fullScreenHideStatusbar());
     cb_smallcursor->setChecked(cfg->smallCursor());
     cb_embedpagenumbers->setChecked(cfg->embedPageNumbers());
-    cb_smoothscaling->setChecked(cfg->smoothScaling());
+    cb_scaling->setCurrentIndex(cfg->scalingQuality());
 
     sb_cachesize->setValue(cfg->cacheSize());
     cb_cacheadjust->setChecked(cfg->cacheAutoAdjust());
@@ -51,7 +51,8 @@ ComicBookCfgDialog::ComicBookCfgDialog(QWidget *parent, ComicBookSettings *cfg):
 
     cb_autoinfo->setChecked(cfg->autoInfo());
     cb_thumbs->setChecked(cfg->cacheThumbnails());
-    sb_thumbsage->setValue(cfg->thumbnailsAge());
+    sb_thumbscachesize->setValue(cfg->thumbnailsCacheSize());
+    sb_thumbworkers->setValue(cfg->thumbnailWorkers());
     cb_splash->setChecked(cfg->showSplash());
     cb_confirmexit->setChecked(cfg->confirmExit());
     le_tempdir->setText(cfg->tmpDir());
@@ -72,7 +73,7 @@ void ComicBookCfgDialog::accept()
 	cfg->fullScreenHideToolbar(cb_hidetoolbar->isChecked());
 	cfg->smallCursor(cb_smallcursor->isChecked());
 	cfg->embedPageNumbers(cb_embedpagenumbers->isChecked());
-	cfg->smoothScaling(cb_smoothscaling->isChecked());
+	cfg->scalingQuality(static_cast<ScalingQuality>(cb_scaling->currentIndex()));
 	cfg->infoFont(font);
 
 	//
@@ -81,7 +82,8 @@ void ComicBookCfgDialog::accept()
 	cfg->cacheAutoAdjust(cb_cacheadjust->isChecked());
 	cfg->preloadPages(cb_preload->isChecked());
 	cfg->cacheThumbnails(cb_thumbs->isChecked());
-	cfg->thumbnailsAge(sb_thumbsage->value());
+	cfg->thumbnailsCacheSize(sb_thumbscachesize->value());
+	cfg->thumbnailWorkers(sb_thumbworkers->value());
 	cfg->autoInfo(cb_autoinfo->isChecked());
 	cfg->showSplash(cb_splash->isChecked());
 	cfg->confirmExit(cb_confirmexit->isChecked());
@@ -20,13 +20,15 @@
 #include <QDir>
 #include <QTextStream>
 #include <QStandardPaths>
+#include <QThread>
 #include <iostream>
 
 #define GRP_VIEW                     "/View"
 #define OPT_TWOPAGES                 "/TwoPages"
 #define OPT_JAPANESEMODE             "/JapaneseMode"
 #define OPT_SCROLLBARS               "/Scrollbars"
-#define OPT_SMOOTHSCALING            "/SmoothScaling"
+#define OPT_SMOOTHSCALING            "/SmoothScaling" // replaced by OPT_SCALINGQUALITY
+#define OPT_SCALINGQUALITY           "/ScalingQuality"
 #define OPT_PAGESIZE                 "/PageSize"
 #define OPT_BACKGROUND               "/Background"
 #define OPT_FULLSCREENHIDEMENU       "/FullScreenHideMenu"
@@ -53,7 +55,8 @@
 #define OPT_AUTOINFO    "/InfoDialog"
 #define OPT_CACHESIZE   "/CacheSize"
 #define OPT_CACHEADJUST "/CacheAutoAdjust"
-#define OPT_THUMBSAGE   "/ThumbnailsAge"
+#define OPT_THUMBSCACHESIZE "/ThumbnailsCacheSize"
+#define OPT_THUMBWORKERS "/ThumbnailWorkers"
 #define OPT_CACHETHUMBS "/CacheThumbnails"
 #define OPT_PRELOAD     "/Preload"
 #define OPT_CONFIRMEXIT "/ConfirmExit"
@@ -79,6 +82,13 @@ const EnumMap<ViewType> ComicBookSettings::viewtype2string[] = {
 	{QString::null}
 };
 
+const EnumMap<ScalingQuality> ComicBookSettings::scaling2string[] = {
+	{"fast", FastScaling},
+	{"smooth", SmoothScaling},
+	{"best", BestScaling},
+	{QString::null}
+};
+
 ComicBookSettings& ComicBookSettings::instance()
 {
     static ComicBookSettings cfg;
@@ -88,6 +98,7 @@ ComicBookSettings& ComicBookSettings::instance()
 ComicBookSettings::ComicBookSettings(): QObject()
                                       , m_bkpath(QString::null)
                                       , m_thpath(QString::null)
+                                      , m_frpath(QString::null)
                                       , m_dirsok(false)
 {
 	m_cfg = new QSettings();
@@ -125,6 +136,17 @@ bool ComicBookSettings::checkDirs()
                 return false;
             }
         }
+
+        m_frpath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QDir::separator() + "frames";
+
+        dir.setPath(m_frpath);
+	if (!dir.exists())
+        {
+            if (!dir.mkpath(m_frpath))
+            {
+                return false;
+            }
+        }
 	return m_dirsok = true;
 }
 
@@ -138,6 +160,11 @@ const QString& ComicBookSettings::thumbnailsDir()
 	return m_thpath;
 }
 
+const QString& ComicBookSettings::framesDir()
+{
+	return m_frpath;
+}
+
 void ComicBookSettings::load()
 {
 	QString fontdesc;
@@ -147,7 +174,8 @@ void ComicBookSettings::load()
 		m_twopages = m_cfg->value(OPT_TWOPAGES, false).toBool();
 		m_japanese = m_cfg->value(OPT_JAPANESEMODE, false).toBool();
 		m_scrollbars = m_cfg->value(OPT_SCROLLBARS, false).toBool();
-		m_smoothscaling = m_cfg->value(OPT_SMOOTHSCALING, true).toBool();
+		m_scaling = convert(scaling2string, m_cfg->value(OPT_SCALINGQUALITY,
+					scaling2string[m_cfg->value(OPT_SMOOTHSCALING, true).toBool() ? SmoothScaling : FastScaling].str).toString());
 		m_pagesize = convert(size2string, m_cfg->value(OPT_PAGESIZE, size2string[0].str).toString());
 		m_bgcolor = m_cfg->value(OPT_BACKGROUND).value<QColor>();
 		m_fscrhidemenu = m_cfg->value(OPT_FULLSCREENHIDEMENU, true).toBool();
@@ -179,7 +207,12 @@ void ComicBookSettings::load()
 		m_confirmexit = m_cfg->value(OPT_CONFIRMEXIT, true).toBool();
 		m_autoinfo = m_cfg->value(OPT_AUTOINFO, false).toBool();
 		m_showsplash = m_cfg->value(OPT_SHOWSPLASH, true).toBool();
-		m_thumbsage = m_cfg->value(OPT_THUMBSAGE, 7).toInt();
+		m_thumbscachesize = m_cfg->value(OPT_THUMBSCACHESIZE, 64).toInt();
+		m_thumbworkers = m_cfg->value(OPT_THUMBWORKERS, QThread::idealThreadCount()).toInt();
+		if (m_thumbworkers < 1)
+                {
+                    m_thumbworkers = 1;
+                }
 		m_cachethumbs = m_cfg->value(OPT_CACHETHUMBS, true).toBool();
 		m_tmpdir = m_cfg->value(OPT_TMPDIR, QString()).toString();
 		QDir dir(m_tmpdir);
@@ -235,9 +268,9 @@ Size ComicBookSettings::pageSize() const
     return m_pagesize;
 }
 
-bool ComicBookSettings::smoothScaling() const
+ScalingQuality ComicBookSettings::scalingQuality() const
 {
-    return m_smoothscaling;
+    return m_scaling;
 }
 
 QString ComicBookSettings::lastDir() const
@@ -270,9 +303,14 @@ bool ComicBookSettings::cacheThumbnails() const
     return m_cachethumbs;
 }
 
-int ComicBookSettings::thumbnailsAge() const
+int ComicBookSettings::thumbnailsCacheSize() const
+{
+    return m_thumbscachesize;
+}
+
+int ComicBookSettings::thumbnailWorkers() const
 {
-    return m_thumbsage;
+    return m_thumbworkers;
 }
 
 bool ComicBookSettings::preloadPages() const
@@ -408,12 +446,12 @@ void ComicBookSettings::pageSize(Size s)
     }
 }
 
-void ComicBookSettings::smoothScaling(bool s)
+void ComicBookSettings::scalingQuality(ScalingQuality q)
 {
-    if (s != m_smoothscaling)
+    if (q != m_scaling)
     {
-        m_cfg->setValue(GRP_VIEW OPT_SMOOTHSCALING, m_smoothscaling = s);
-        emit displaySettingsChanged(OPT_SMOOTHSCALING);
+        m_cfg->setValue(GRP_VIEW OPT_SCALINGQUALITY, convert(scaling2string, m_scaling = q));
+        emit displaySettingsChanged(OPT_SCALINGQUALITY);
     }
 }
 
@@ -470,11 +508,19 @@ void ComicBookSettings::cacheThumbnails(bool f)
     }
 }
 
-void ComicBookSettings::thumbnailsAge(int n)
+void ComicBookSettings::thumbnailsCacheSize(int n)
+{
+    if (n != m_thumbscachesize)
+    {
+        m_cfg->setValue(GRP_MISC OPT_THUMBSCACHESIZE, m_thumbscachesize = n);
+    }
+}
+
+void ComicBookSettings::thumbnailWorkers(int n)
 {
-    if (n != m_thumbsage)
+    if (n != m_thumbworkers)
     {
-        m_cfg->setValue(GRP_MISC OPT_THUMBSAGE, m_thumbsage = n);
+        m_cfg->setValue(GRP_MISC OPT_THUMBWORKERS, m_thumbworkers = n);
     }
 }
 
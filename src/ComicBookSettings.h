@@ -46,14 +46,15 @@ namespace QComicBook
 			ViewType viewType() const;
 			bool scrollbarsVisible() const;
 			Size pageSize() const;
-			bool smoothScaling() const;
+			ScalingQuality scalingQuality() const;
 			QString lastDir() const;
 			const QStringList& recentlyOpened() const;
 			QColor background() const;
 			int cacheSize() const;
 			bool cacheAutoAdjust() const;
 			bool cacheThumbnails() const;
-			int thumbnailsAge() const;
+			int thumbnailsCacheSize() const;
+			int thumbnailWorkers() const;
 			bool preloadPages() const;
 			bool confirmExit() const;
 			bool autoInfo() const;
@@ -76,14 +77,15 @@ namespace QComicBook
 			void viewType(ViewType t);
 			void scrollbarsVisible(bool f);
 			void pageSize(Size s);
-			void smoothScaling(bool s);
+			void scalingQuality(ScalingQuality q);
 			void lastDir(const QString &d);
 			void recentlyOpened(const QStringList &hist);
 			void background(const QColor &color);
 			void cacheSize(int s);
 			void cacheAutoAdjust(bool f);
 			void cacheThumbnails(bool f);
-			void thumbnailsAge(int n);
+			void thumbnailsCacheSize(int n);
+			void thumbnailWorkers(int n);
 			void preloadPages(bool f);
 			void confirmExit(bool f);
 			void autoInfo(bool f);
@@ -106,6 +108,7 @@ namespace QComicBook
 			bool checkDirs();
 			const QString& bookmarksDir();
 			const QString& thumbnailsDir();
+			const QString& framesDir();
 
 		private:
 			QSettings *m_cfg;
@@ -122,12 +125,13 @@ namespace QComicBook
 			bool m_fscrhidetoolbar;
 			Size m_pagesize;
 			ViewType m_viewtype;
-			bool m_smoothscaling;
+			ScalingQuality m_scaling;
 			QString m_lastdir;
 			QColor m_bgcolor;
 			QStringList m_recent;
 			int m_cachesize;
-			int m_thumbsage;
+			int m_thumbscachesize;
+			int m_thumbworkers;
 			bool m_cacheadjust;
 			bool m_cachethumbs;
 			bool m_autoinfo;
@@ -141,10 +145,12 @@ namespace QComicBook
 
 			QString m_bkpath; //bookmarks path
 			QString m_thpath; //thumbnails cache path
+			QString m_frpath; //detected frames cache path
 			bool m_dirsok; //is above dirs are ok
 
 			static const EnumMap<Size> size2string[];
 			static const EnumMap<ViewType> viewtype2string[];
+			static const EnumMap<ScalingQuality> scaling2string[];
 
 			ComicBookSettings();
 			ComicBookSettings(const ComicBookSettings &);
@@ -37,6 +37,7 @@ ComicFrameImage::~ComicFrameImage()
 void ComicFrameImage::setFrame(const Page &p, const ComicFrame &f)
 {
     _DEBUG;
+    invalidate();
     m_image = new QImage(p.getImage());
     m_frame = QRect(f.xPos(), f.yPos(), f.width(), f.height());
     m_framekey = ((f.xPos() & 0xffff) << 16) | (f.yPos() & 0xffff);
@@ -51,7 +52,8 @@ ImageTransformJob* ComicFrameImage::createRedrawJob()
     if (m_image)
     {
         j = new FrameRedrawJob();
-        j->setKey(JobKey(FRAME_REDRAW, m_framekey));
+        j->setKey(JobKey(FRAME_REDRAW, m_framekey, this));
+        j->setViewProperties(view()->properties().getProperties());
         j->setImage(*m_image, m_frame);
     }
     return j;
@@ -60,15 +62,20 @@ ImageTransformJob* ComicFrameImage::createRedrawJob()
 bool ComicFrameImage::jobCompleted(const ImageJobResult &result)
 {
     _DEBUG << result.key;
-    if (m_image && result.key.getKey() == m_framekey)
+    if (m_image && result.key == JobKey(FRAME_REDRAW, m_framekey, this))
     {
         _DEBUG << "matching job" << result.key;
-        redraw(result.image);
+        redraw(result);
         return true;
     }
     return false;
 }
 
+bool ComicFrameImage::isDisposed() const
+{
+    return m_image == 0;
+}
+
 void ComicFrameImage::clear()
 {
 	delete m_image;
@@ -32,6 +32,7 @@ namespace QComicBook
             
             void setFrame(const Page &p, const ComicFrame &f);
             void clear();
+            virtual bool isDisposed() const;
             ImageTransformJob *createRedrawJob();
             bool jobCompleted(const ImageJobResult &result);
             void propsChanged();
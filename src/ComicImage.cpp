@@ -15,6 +15,7 @@
 #include <QStyleOptionGraphicsItem>
 #include "ComicBookSettings.h"
 #include "View/PageViewBase.h"
+#include "View/RedrawScheduler.h"
 #include "ImageTransformJob.h"
 #include "ImageJobResult.h"
 #include "ImageTransformThread.h"
@@ -25,29 +26,26 @@ using namespace QComicBook;
 ComicImage::ComicImage(PageViewBase *parent)
     : QGraphicsItem()
     , m_view(parent)
+    , m_stale(true)
+    , m_generation(0)
     , m_sourceSize(0, 0)
     , m_scaledSize(0, 0)
-    , m_pixmap(0)
 {
 }
 
 ComicImage::~ComicImage()
 {
-    delete m_pixmap;
+    m_view->redrawScheduler()->remove(this);
 }
 
 void ComicImage::dispose()
 {
-    delete m_pixmap;
-    m_pixmap = 0;
+    m_view->redrawScheduler()->remove(this);
+    m_image = QImage(); // buffer goes back to the pool
+    m_preview = QImage();
 //	m_scaledSize = QSize(0, 0); //?
 }
 
-bool ComicImage::isDisposed() const
-{
-    return m_pixmap == NULL;
-}
-
 QRectF ComicImage::boundingRect() const
 {
     return QRectF(0.0f, 0.0f, m_scaledSize.width(), m_scaledSize.height());
@@ -144,47 +142,116 @@ void ComicImage::recalcScaledSize()
     xoff = (viewW - pixmapWidth) / 2;
     yoff = props.continuousScrolling() ? 0 : (viewH - pixmapHeight) / 2;
     
-    prepareGeometryChange();
-
-    m_scaledSize = QSize(pixmapWidth, pixmapHeight);
-    
     if (xoff < 0)
         xoff = 0;
     if (yoff < 0)
         yoff = 0;
 	
-    rmtx.reset();   
-    if (props.angle() > 0)
+    //setContentsMargins(xoff, yoff, 0, 0);
+    //setFixedSize(m_scaledSize.width() + 2*xoff, m_scaledSize.height() + 2*yoff);  
+
+    const QSize scaledSize(pixmapWidth, pixmapHeight);
+    setScaledGeometry(scaledSize, scaleMatrix(m_sourceSize, scaledSize, props.angle()));
+}
+
+QMatrix ComicImage::scaleMatrix(const QSize &source, const QSize &scaled, int angle)
+{
+    QMatrix mtx;
+    if (angle > 0)
     {
-        if (props.angle() == 1)
-            rmtx.translate(m_scaledSize.width(), 0);
-        else if (props.angle() == 3)
-            rmtx.translate(0, m_scaledSize.height());
+        if (angle == 1)
+            mtx.translate(scaled.width(), 0);
+        else if (angle == 3)
+            mtx.translate(0, scaled.height());
         else
-            rmtx.translate(m_scaledSize.width(), m_scaledSize.height());
-        rmtx.rotate(static_cast<double>(props.angle()) * 90.0f);
+            mtx.translate(scaled.width(), scaled.height());
+        mtx.rotate(static_cast<double>(angle) * 90.0f);
     }
-    
-    rmtx.scale(static_cast<double>(pixmapWidth)/totalWidth, static_cast<double>(pixmapHeight)/totalHeight);
-	
-    //setContentsMargins(xoff, yoff, 0, 0);
-    //setFixedSize(m_scaledSize.width() + 2*xoff, m_scaledSize.height() + 2*yoff);  
+    const QSize rotated((angle & 1) ? scaled.transposed() : scaled);
+    mtx.scale(static_cast<double>(rotated.width())/source.width(), static_cast<double>(rotated.height())/source.height());
+    return mtx;
+}
 
-    requestRedraw(m_scaledSize, rmtx);
+void ComicImage::setScaledGeometry(const QSize &size, const QMatrix &mtx)
+{
+    prepareGeometryChange();
+
+    //
+    // same size may come with different transformation, e.g. when rotated by 180 degrees
+    if (size != m_scaledSize || mtx != rmtx)
+    {
+        invalidate();
+    }
+    m_scaledSize = size;
+    rmtx = mtx;
+
+    m_view->redrawScheduler()->schedule(this);
 
     //updateGeometry();
     update();
 }
 
+void ComicImage::invalidate()
+{
+    m_stale = true;
+    m_preview = QImage();
+    ++m_generation;
+    update();
+}
+
+const QMatrix& ComicImage::scaledMatrix() const
+{
+    return rmtx;
+}
+
 void ComicImage::paint(QPainter *painter, const QStyleOptionGraphicsItem *opt, QWidget *widget)
 {
-    if (m_pixmap)
+    if (!m_image.isNull() && !m_stale)
     {
-//      painter->drawPixmap(opt->rect().x(), opt->rect().y(), *m_pixmap, opt->rect().x()-xoff, opt->rect().y()-yoff, opt->rect().width(), opt->rect().height());
-        painter->drawPixmap(opt->exposedRect, *m_pixmap, opt->exposedRect);
+        //
+        // RGB32 and premultiplied images are drawn by raster engine as fast as pixmaps
+        painter->drawImage(opt->exposedRect, m_image, opt->exposedRect);
+    }
+    else if (!paintPreview(painter, opt->exposedRect) && !m_image.isNull())
+    {
+        //
+        // redraw at new size is pending and there is no source to preview, stretch the old result
+        painter->drawImage(boundingRect(), m_image);
     }
 }
 
+bool ComicImage::paintPreview(QPainter *painter, const QRectF &exposed)
+{
+    if (m_preview.isNull())
+    {
+        if (m_scaledSize.isEmpty())
+        {
+            return false;
+        }
+        ImageTransformJob *j = createRedrawJob();
+        if (!j)
+        {
+            return false;
+        }
+        j->setSize(m_scaledSize.width(), m_scaledSize.height());
+        j->setMatrix(rmtx);
+
+        m_preview = QImage(m_scaledSize, QImage::Format_ARGB32_Premultiplied);
+        m_preview.fill(0);
+        QPainter p(&m_preview);
+        j->paintPreview(p);
+        p.end();
+        delete j;
+    }
+    painter->drawImage(exposed, m_preview, exposed);
+    return true;
+}
+
+void ComicImage::requestRedraw()
+{
+    requestRedraw(m_scaledSize, rmtx);
+}
+
 void ComicImage::requestRedraw(const QSize& requestedSize, const QMatrix &rotationMatrix)
 {
     ViewProperties &props(m_view->properties());
@@ -194,26 +261,24 @@ void ComicImage::requestRedraw(const QSize& requestedSize, const QMatrix &rotati
     {
         j->setSize(requestedSize.width(), requestedSize.height());
         j->setMatrix(rotationMatrix);
+        j->setGeneration(m_generation);
         ImageTransformThread::get()->addJob(j);
     }
 }
 
-void ComicImage::redraw(const QImage &img)
+void ComicImage::redraw(const ImageJobResult &result)
 {
     _DEBUG;
-    if (img.size() == m_scaledSize) // sanity check; should match size requested in requestRedraw(..)
+    if (result.generation != m_generation)
     {
-        if (m_pixmap != NULL && m_pixmap->size() == img.size()) // reuse existing pixmap if of right size
-        {
-            QPainter p(m_pixmap);
-            p.drawImage(0, 0, img);
-            p.end();
-        }
-        else
-        {
-            delete m_pixmap;
-            m_pixmap = new QPixmap(QPixmap::fromImage(img));
-        }
+        _DEBUG << "ignoring result requested before source or geometry changed";
+        return;
+    }
+    if (result.image.size() == m_scaledSize) // sanity check; should match size requested in requestRedraw(..)
+    {
+        m_image = result.image; // adopt job's buffer, no copy
+        m_stale = false;
+        m_preview = QImage();
         update();
     }
     else
@@ -222,9 +287,9 @@ void ComicImage::redraw(const QImage &img)
     }
 }
 
-const QPixmap* ComicImage::pixmap() const
+const QImage& ComicImage::image() const
 {
-    return m_pixmap;
+    return m_image;
 }
 
 PageViewBase* ComicImage::view() const
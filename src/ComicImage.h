@@ -17,16 +17,16 @@
 #include <QSize>
 #include <QMatrix>
 #include <QGraphicsItem>
-#include <QPixmap>
+#include <QImage>
 #include "JobSource.h"
 #include "Counted.h"
 
-class QPixmap;
 class QPainter;
 
 namespace QComicBook
 {
 	class PageViewBase;
+	struct ImageJobResult;
 
 	class ComicImage: public QGraphicsItem, public JobSource, public Counted<ComicImage>
 	{
@@ -34,19 +34,27 @@ namespace QComicBook
             ComicImage(PageViewBase *parent);
             virtual ~ComicImage();
             
+            //! Releases redrawn image; subclasses release source image as well.
             virtual void dispose();
-            virtual bool isDisposed() const;
+            //! Tells if source image was released (or not set yet); doesn't tell if image was redrawn.
+            virtual bool isDisposed() const = 0;
             
             bool isInView(int vy1, int vy2) const;
             void setSourceSize(int w, int h);
             QSize getSourceSize() const;
             QSize getScaledSize() const;
-            const QPixmap* pixmap() const;
+            const QImage& image() const;
             QRectF boundingRect() const;
             
+            //! Starts redraw job for current size; normally called by RedrawScheduler.
             void requestRedraw();
             PageViewBase* view() const;
+            //! Recalculates size of the image in the view and schedules its redraw.
             void recalcScaledSize();
+            //! Sets size of the image in the view and transformation of source to it; schedules redraw.
+            /*! Called by recalcScaledSize(); items placed by other items are sized with it directly. */
+            virtual void setScaledGeometry(const QSize &size, const QMatrix &mtx);
+            const QMatrix& scaledMatrix() const;
             int width() const;
             int height() const;
             
@@ -54,12 +62,25 @@ namespace QComicBook
 
         protected:
             void paint(QPainter *painter, const QStyleOptionGraphicsItem *opt, QWidget *widget = 0);
-            void redraw(const QImage &img);
+            //! Shows result of redraw job; results of jobs requested before last geometry or source change are ignored.
+            void redraw(const ImageJobResult &result);
+            //! Tells that source image changed; current image isn't shown anymore, preview is shown until it's redrawn.
+            void invalidate();
+            //! Paints nearest-neighbour version of the image from its source.
+            /*! Shown while smooth redraw at current geometry is pending; it's made once
+             *  and kept until the redraw arrives or geometry changes again.
+             *  @return false if there is no source to paint */
+            bool paintPreview(QPainter *painter, const QRectF &exposed);
             virtual void requestRedraw(const QSize& requestedSize, const QMatrix &rotationMatrix);
+            //! Returns transformation of source image to scaled size, turned by angle quarters.
+            static QMatrix scaleMatrix(const QSize &source, const QSize &scaled, int angle);
 
         private:
             PageViewBase *m_view;
-            QPixmap *m_pixmap;
+            QImage m_image; //!< result of last redraw job, shown as is
+            bool m_stale; //!< m_image was made for different source, size or transformation
+            int m_generation; //!< incremented on each geometry or source change; see ImageTransformJob::setGeneration()
+            QImage m_preview; //!< see paintPreview()
             int xoff, yoff;
             QMatrix rmtx;
             QSize m_sourceSize; //image size without scaling
@@ -30,14 +30,17 @@
 #include "ThumbnailsWindow.h"
 #include "ThumbnailsView.h"
 #include "ThumbnailLoaderThread.h"
+#include "ThumbnailDatabase.h"
 #include "BookmarkManager.h"
 #include "Utility.h"
 #include "SystemInfoDialog.h"
 #include "GoToPageWidget.h"
 #include "PageLoaderThread.h"
+#include "PrefetchPolicy.h"
 #include "RecentFilesMenu.h"
 #include "PrinterThread.h"
 #include <FrameDetectThread.h>
+#include <FrameCache.h>
 #include "PrintProgressDialog.h"
 #include "Job/ImageTransformThread.h"
 #include "Debug/DebugController.h"
@@ -76,6 +79,7 @@ ComicMainWindow::ComicMainWindow(QWidget *parent): QMainWindow(parent), currpage
     printer = QSharedPointer<QPrinter>(new QPrinter());
 
     pageLoader = new PageLoaderThread();
+    thumbnailLoader = new ThumbnailLoaderThread();
     frameDetect = new FrameDetectThread();
 
     //
@@ -299,8 +303,8 @@ ComicMainWindow::ComicMainWindow(QWidget *parent): QMainWindow(parent), currpage
     pageLoader->start();
     frameDetect->start();
 
-    thumbnailLoader = new ThumbnailLoaderThread();
-    connect(thumbnailLoader, SIGNAL(thumbnailLoaded(const Thumbnail &)), thumbswin, SLOT(setThumbnail(const Thumbnail &)));
+    connect(thumbnailLoader, SIGNAL(thumbnailsLoaded(const QList<Thumbnail> &)), thumbswin, SLOT(setThumbnails(const QList<Thumbnail> &)));
+    connect(thumbswin->view(), SIGNAL(visibleRangeChanged(int, int, int)), thumbnailLoader, SLOT(setVisibleRange(int, int, int)));
     thumbnailLoader->start();
 }
 
@@ -310,8 +314,9 @@ ComicMainWindow::~ComicMainWindow()
 
     if (cfg->cacheThumbnails())
     {
-        ImgDirSink::removeThumbnails(cfg->thumbnailsAge());
+        ThumbnailDatabase::removeLeastRecentlyUsed(static_cast<qint64>(cfg->thumbnailsCacheSize()) * 1024 * 1024);
     }
+    FrameCache::removeLeastRecentlyUsed();
 
     saveSettings();        
     
@@ -439,10 +444,14 @@ void ComicMainWindow::setupComicImageView()
     connect(view, SIGNAL(currentPageChanged(int)), this, SLOT(currentPageChanged(int)));
     connect(pageLoader, SIGNAL(pageLoaded(const Page&)), view, SLOT(setImage(const Page&)));
     connect(pageLoader, SIGNAL(pageLoaded(const Page&, const Page&)), view, SLOT(setImage(const Page&, const Page&)));
+    //
+    // let thumbnail loader reuse decoded pages
+    connect(pageLoader, SIGNAL(pageLoaded(const Page&)), thumbnailLoader, SLOT(pageDecoded(const Page&)));
+    connect(pageLoader, SIGNAL(pageLoaded(const Page&, const Page&)), thumbnailLoader, SLOT(pageDecoded(const Page&, const Page&)));
     connect(view, SIGNAL(pageReady(const Page &)), this, SLOT(pageLoaded(const Page &)));
     connect(view, SIGNAL(pageReady(const Page &, const Page &)), this, SLOT(pageLoaded(const Page &, const Page &)));
-    connect(view, SIGNAL(requestPage(int)), pageLoader, SLOT(request(int)));
-    connect(view, SIGNAL(requestTwoPages(int)), pageLoader, SLOT(requestTwoPages(int)));
+    connect(view, SIGNAL(requestPage(int, int)), pageLoader, SLOT(requestPage(int, int)));
+    connect(view, SIGNAL(requestTwoPages(int, int)), pageLoader, SLOT(requestTwoPages(int, int)));
     connect(view, SIGNAL(cancelPageRequest(int)), pageLoader, SLOT(cancel(int)));
     connect(view, SIGNAL(cancelTwoPagesRequest(int)), pageLoader, SLOT(cancelTwoPages(int)));
 
@@ -695,6 +704,9 @@ void ComicMainWindow::sinkReady(const QString &path)
         updateCaption();
         statusbar->setName(sink->getFullName());
 
+        FrameCache::instance().setComicBook(sink->contentKey());
+        PrefetchPolicy::instance().reset();
+
         view->setNumOfPages(sink->numOfImages()); //FIXME
         thumbswin->view()->setPages(sink->numOfImages());
 
@@ -768,6 +780,7 @@ void ComicMainWindow::open(const QString &path, int page)
         pageLoader->setSink(sink);
         thumbnailLoader->setSink(sink);
         thumbnailLoader->setUseCache(cfg->cacheThumbnails());
+        thumbnailLoader->setWorkers(cfg->thumbnailWorkers());
 
         connect(sink.data(), SIGNAL(progress(int, int)), statusbar, SLOT(setProgress(int, int)));
 
@@ -925,6 +938,7 @@ void ComicMainWindow::currentPageChanged(int n)
     _DEBUG << n;
 
     currpage = n;
+    PrefetchPolicy::instance().pageShown(n);
     const QString page = tr("Page") + " " + QString::number(n + 1) + "/" + QString::number(sink->numOfImages());
     pageinfo->setText(page);
     statusbar->setPage(n + 1, sink->numOfImages());
@@ -1035,6 +1049,8 @@ void ComicMainWindow::closeSink()
     if (sink)
     {
 	frameDetect->clear();
+        FrameCache::instance().setComicBook(QByteArray());
+        PrefetchPolicy::instance().reset();
         pageLoader->cancelAll();
         pageLoader->setSink();
         thumbnailLoader->cancelAll();
@@ -1185,6 +1201,7 @@ void ComicMainWindow::reconfigureDisplay()
 
     view->setSmallCursor(cfg->smallCursor());
     view->showPageNumbers(cfg->embedPageNumbers());
+    view->setScalingQuality(cfg->scalingQuality());
     view->setBackground(cfg->background());
 }
 
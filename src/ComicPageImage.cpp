@@ -11,6 +11,7 @@
  */
 
 #include "ComicPageImage.h"
+#include "ComicSpreadPageImage.h"
 #include "Page.h"
 #include "View/PageViewBase.h"
 #include "ComicBookSettings.h"
@@ -33,6 +34,7 @@ ComicPageImage::ComicPageImage(PageViewBase *parent, int w, int h, int pageNum,
     , estimated(true)
 {
     m_image[0] = m_image[1] = NULL;
+    m_spread[0] = m_spread[1] = NULL;
 }
 
 ComicPageImage::~ComicPageImage()
@@ -49,14 +51,18 @@ void ComicPageImage::deletePages()
 {
     for (int i=0; i<2; i++)
     {
+        delete m_spread[i];
+        m_spread[i] = NULL;
         delete m_image[i];
         m_image[i] = NULL;
     }
+    m_uncovered = QRegion();
 }
 
 void ComicPageImage::setImage(const Page &img1)
 {
     deletePages();
+    invalidate();
     m_image[0] = new Page(img1);
     m_twoPages = false;
     estimated = false;
@@ -66,8 +72,13 @@ void ComicPageImage::setImage(const Page &img1)
 void ComicPageImage::setImage(const Page &img1, const Page &img2)
 {
     deletePages();
+    invalidate();
     m_image[0] = new Page(img1);
     m_image[1] = new Page(img2);
+    for (int i=0; i<2; i++)
+    {
+        m_spread[i] = new ComicSpreadPageImage(view(), this, *m_image[i]);
+    }
     m_twoPages = true;
     estimated = false;
     redrawImages();
@@ -90,7 +101,12 @@ void ComicPageImage::dispose()
 		
 bool ComicPageImage::isDisposed() const
 {
-    return ComicImage::isDisposed() || (m_image[0] == NULL);
+    return !isLoaded();
+}
+
+bool ComicPageImage::isLoaded() const
+{
+    return m_image[0] != NULL;
 }
 
 void ComicPageImage::setEstimatedSize(int w, int h)
@@ -124,21 +140,12 @@ ImageTransformJob* ComicPageImage::createRedrawJob()
 {
     _DEBUG;
     PageRedrawJob *j = NULL;
-    if (m_image[0])
+    if (m_image[0] && !m_spread[0]) // pages of spread are redrawn on their own
     {
         j = new PageRedrawJob();
-        j->setKey(JobKey(PAGE_REDRAW, m_image[0]->getNumber()));
-        j->setSourceSize(getSourceSize());
+        j->setKey(JobKey(PAGE_REDRAW, m_image[0]->getNumber(), this));
         j->setViewProperties(view()->properties().getProperties());
-
-        if (m_image[1])
-        {
-            j->setImage(*m_image[0], *m_image[1]);
-        }
-        else
-        {
-            j->setImage(*m_image[0]);
-        }
+        j->setImage(*m_image[0]);
     }
     return j;
 }
@@ -146,15 +153,84 @@ ImageTransformJob* ComicPageImage::createRedrawJob()
 bool ComicPageImage::jobCompleted(const ImageJobResult &result)
 {
     _DEBUG << result.key;
-    if (m_image[0] && result.key.getKey() == m_image[0]->getNumber())
+    if (m_spread[0])
+    {
+        return m_spread[0]->jobCompleted(result) || m_spread[1]->jobCompleted(result);
+    }
+    if (m_image[0] && result.key == JobKey(PAGE_REDRAW, m_image[0]->getNumber(), this))
     {
         _DEBUG << "job for page" << m_image[0]->getNumber();
-        redraw(result.image);
+        redraw(result);
         return true;
     }
     return false;
 }
 
+void ComicPageImage::setScaledGeometry(const QSize &size, const QMatrix &mtx)
+{
+    ComicImage::setScaledGeometry(size, mtx);
+    layoutPages();
+}
+
+void ComicPageImage::layoutPages()
+{
+    m_uncovered = QRegion();
+    if (!m_spread[0])
+    {
+        return;
+    }
+
+    ViewProperties &props = view()->properties();
+    const int swap = props.mangaMode() ? 1 : 0;
+    const QRect bounds(QPoint(0, 0), getScaledSize());
+    int srcx = 0;
+    for (int i=0; i<2; i++)
+    {
+        ComicSpreadPageImage *page = m_spread[i^swap];
+        const QSize size(page->getPage().width(), page->getPage().height());
+        const QRect r(PageRedrawJob::mapRect(scaledMatrix(), QRectF(QPointF(srcx, 0), size)).intersected(bounds));
+        page->setPos(r.topLeft());
+        page->setScaledGeometry(r.size(), scaleMatrix(size, r.size(), props.angle()));
+
+        //
+        // shorter page leaves part of its slot to background
+        m_uncovered += QRegion(PageRedrawJob::mapRect(scaledMatrix(), QRectF(srcx, 0, size.width(), getSourceSize().height())).intersected(bounds)).subtracted(r);
+        srcx += size.width();
+    }
+}
+
+void ComicPageImage::paint(QPainter *painter, const QStyleOptionGraphicsItem *opt, QWidget *widget)
+{
+    ComicImage::paint(painter, opt, widget);
+    foreach (const QRect &r, m_uncovered.rects())
+    {
+        painter->fillRect(r, view()->properties().background());
+    }
+    if (view()->properties().pageNumbers())
+    {
+        paintPageNumber(painter);
+    }
+}
+
+void ComicPageImage::paintPageNumber(QPainter *painter) const
+{
+    if (!m_image[0])
+    {
+        return;
+    }
+    const int page = m_image[1] ? std::max(m_image[0]->getNumber(), m_image[1]->getNumber()) : m_image[0]->getNumber();
+    const QString pagestr(QString::number(page + 1));
+    const QFontMetrics mtr(painter->fontMetrics());
+    const int txtw(mtr.width(pagestr));
+    const int x = width();
+    const int y = height();
+    painter->save();
+    painter->setPen(Qt::black);
+    painter->fillRect(x - txtw - 5, y - 2 - mtr.height(), txtw + 5, mtr.height() + 4, Qt::white);
+    painter->drawText(x - txtw - 4, y - 4, pagestr);
+    painter->restore();
+}
+
 void ComicPageImage::redrawImages()
 {
     const int pages = numOfPages();
@@ -14,12 +14,17 @@
 #define __COMIC_PAGE_IMAGE_H
 
 #include "ComicImage.h"
+#include <QRegion>
 
 namespace QComicBook
 {
     class Page;
     class PageViewBase;
+    class ComicSpreadPageImage;
 
+    //! Page or two pages spread shown in the view.
+    /*! Pages of a spread are child items, see ComicSpreadPageImage; the spread itself only paints
+     *  background next to the shorter page and page number. */
     class ComicPageImage: public ComicImage
     {
     public:
@@ -34,6 +39,8 @@ namespace QComicBook
 
         virtual void dispose();
         virtual bool isDisposed() const;
+        //! Tells if source pages are set; they may still wait for redraw.
+        bool isLoaded() const;
 
         void redrawImages();
         void setEstimatedSize(int w, int h);
@@ -45,13 +52,20 @@ namespace QComicBook
 		
         virtual void propsChanged();
         bool jobCompleted(const ImageJobResult &result);
+        //! Places pages of spread as well.
+        virtual void setScaledGeometry(const QSize &size, const QMatrix &mtx);
 
     protected:
+        void paint(QPainter *painter, const QStyleOptionGraphicsItem *opt, QWidget *widget = 0);
+        void paintPageNumber(QPainter *painter) const;
+        void layoutPages();
         void deletePages();
         
     private:
         int m_pageNum; //number of physical page
         Page *m_image[2];
+        ComicSpreadPageImage *m_spread[2]; //!< pages of spread in the order they are in m_image
+        QRegion m_uncovered; //!< area of spread not covered by pages
         QSize pageSize; //size of 1 or 2 pages without scaling
         bool estimated;
         bool m_twoPages; //whether this widget holds one or two pages; this is independent from current two pages mode setting
@@ -0,0 +1,68 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2012 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+#include "ComicSpreadPageImage.h"
+#include "ComicPageImage.h"
+#include "View/PageViewBase.h"
+#include "ComicBookDebug.h"
+#include "Job/PageRedrawJob.h"
+#include "Job/ImageJobResult.h"
+#include "Job/JobType.h"
+
+using namespace QComicBook;
+
+ComicSpreadPageImage::ComicSpreadPageImage(PageViewBase *view, ComicPageImage *spread, const Page &page)
+    : ComicImage(view)
+    , m_page(page)
+{
+    setParentItem(spread);
+    setFlag(QGraphicsItem::ItemStacksBehindParent); // page number of spread is painted over pages
+}
+
+ComicSpreadPageImage::~ComicSpreadPageImage()
+{
+}
+
+ImageTransformJob* ComicSpreadPageImage::createRedrawJob()
+{
+    _DEBUG;
+    PageRedrawJob *j = new PageRedrawJob();
+    j->setKey(JobKey(PAGE_REDRAW, m_page.getNumber(), this));
+    j->setViewProperties(view()->properties().getProperties());
+    j->setImage(m_page);
+    return j;
+}
+
+bool ComicSpreadPageImage::jobCompleted(const ImageJobResult &result)
+{
+    if (result.key == JobKey(PAGE_REDRAW, m_page.getNumber(), this))
+    {
+        _DEBUG << "job for page" << m_page.getNumber();
+        redraw(result);
+        return true;
+    }
+    return false;
+}
+
+const Page& ComicSpreadPageImage::getPage() const
+{
+    return m_page;
+}
+
+bool ComicSpreadPageImage::isDisposed() const
+{
+    return false;
+}
+
+void ComicSpreadPageImage::propsChanged()
+{
+}
@@ -0,0 +1,47 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2012 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+#ifndef __COMIC_SPREAD_PAGE_IMAGE_H
+#define __COMIC_SPREAD_PAGE_IMAGE_H
+
+#include "ComicImage.h"
+#include "Page.h"
+
+namespace QComicBook
+{
+    class PageViewBase;
+    class ComicPageImage;
+
+    //! One page of two pages spread.
+    /*! Child item of ComicPageImage, which places it and sets its size. Each page of a spread
+     *  is redrawn by its own job and shown as soon as it's ready. */
+    class ComicSpreadPageImage: public ComicImage
+    {
+    public:
+        ComicSpreadPageImage(PageViewBase *view, ComicPageImage *spread, const Page &page);
+        virtual ~ComicSpreadPageImage();
+
+        ImageTransformJob *createRedrawJob();
+        bool jobCompleted(const ImageJobResult &result);
+        const Page& getPage() const;
+        //! Always false; page is released together with the spread.
+        virtual bool isDisposed() const;
+
+        //! Does nothing; geometry follows the spread.
+        virtual void propsChanged();
+
+    private:
+        Page m_page;
+    };
+}
+
+#endif
@@ -0,0 +1,105 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2010 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+#include "ContentHash.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QImage>
+
+using namespace QComicBook;
+
+const int ContentHash::SAMPLE_SIZE = 4096;
+const int ContentHash::SAMPLED_ROWS = 32;
+
+ContentHash::ContentHash()
+    : m_hash(Q_UINT64_C(14695981039346656037))
+{
+}
+
+void ContentHash::add(const char *data, int len)
+{
+    for (int i=0; i<len; i++)
+    {
+        m_hash ^= static_cast<uchar>(data[i]);
+        m_hash *= Q_UINT64_C(1099511628211);
+    }
+}
+
+void ContentHash::add(const QByteArray &data)
+{
+    add(data.constData(), data.size());
+}
+
+void ContentHash::add(qint64 value)
+{
+    for (int i=0; i<8; i++)
+    {
+        const char c = static_cast<char>(value >> (i * 8));
+        add(&c, 1);
+    }
+}
+
+bool ContentHash::addFile(const QString &path)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    const QFileInfo finfo(f);
+    const qint64 size = f.size();
+    add(size);
+    add(finfo.lastModified().toMSecsSinceEpoch());
+
+    //
+    // sample beginning, middle and end of the file
+    const qint64 offsets[3] = { 0, (size - SAMPLE_SIZE) / 2, size - SAMPLE_SIZE };
+    for (int i=0; i<3; i++)
+    {
+        if (f.seek(qMax(offsets[i], Q_INT64_C(0))))
+        {
+            add(f.read(SAMPLE_SIZE));
+        }
+    }
+    return true;
+}
+
+void ContentHash::addImage(const QImage &img)
+{
+    add(static_cast<qint64>(img.width()));
+    add(static_cast<qint64>(img.height()));
+
+    //
+    // rows of palette and grayscale images are hashed as 32 bits per pixel, so that the hash
+    // doesn't change when the same page is kept in different format (see ImgSink::compactImage())
+    const int rows = qMin(img.height(), SAMPLED_ROWS);
+    const int len = img.width() * 4;
+    for (int i=0; i<rows; i++)
+    {
+        const int y = rows > 1 ? (img.height() - 1) * i / (rows - 1) : 0;
+        if (img.depth() == 32)
+        {
+            add(reinterpret_cast<const char *>(img.constScanLine(y)), len);
+        }
+        else
+        {
+            const QImage row(img.copy(0, y, img.width(), 1).convertToFormat(QImage::Format_RGB32));
+            add(reinterpret_cast<const char *>(row.constScanLine(0)), len);
+        }
+    }
+}
+
+QByteArray ContentHash::result() const
+{
+    return QByteArray::number(m_hash, 16);
+}
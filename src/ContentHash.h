@@ -0,0 +1,57 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2010 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+/*! \file ContentHash.h */
+
+#ifndef __CONTENTHASH_H
+#define __CONTENTHASH_H
+
+#include <QByteArray>
+
+class QString;
+class QImage;
+
+namespace QComicBook
+{
+    //! Fast non-cryptographic (FNV-1a) hash used to identify comic books and pages by contents.
+    /*! Identities built with this class are shared by disk caches, so a comic book that is
+     *  renamed or moved keeps its thumbnails and detected frames, while two comic books with
+     *  the same name don't collide.
+     */
+    class ContentHash
+    {
+        public:
+            ContentHash();
+
+            void add(const char *data, int len);
+            void add(const QByteArray &data);
+            void add(qint64 value);
+
+            //! Adds size, modification time and sampled contents of a file.
+            /*! @return false if file can't be read */
+            bool addFile(const QString &path);
+
+            //! Adds dimensions and sampled scanlines of an image; result doesn't depend on pixel depth.
+            void addImage(const QImage &img);
+
+            //! @return hash as a hex string, suitable for file names
+            QByteArray result() const;
+
+        private:
+            static const int SAMPLE_SIZE; //!< size of each sampled block of a file
+            static const int SAMPLED_ROWS; //!< number of sampled scanlines of an image
+
+            quint64 m_hash;
+    };
+}
+
+#endif
@@ -12,6 +12,8 @@
 
 #include "MemoryDebug.h"
 #include "ComicImage.h"
+#include "PrefetchPolicy.h"
+#include "ImageBufferPool.h"
  
 namespace QComicBook
 {
@@ -40,6 +42,24 @@ void MemoryDebug::refresh()
     debug_text->clear();
     appendObjectCount("ComicImage", Counted<ComicImage>::objectCount(), Counted<ComicImage>::objectTotal());
     appendObjectCount("ImageTransformJob", Counted<ImageTransformJob>::objectCount(), Counted<ImageTransformJob>::objectTotal());
+    appendPrefetchStats();
+    appendBufferPoolStats();
+}
+
+void MemoryDebug::appendPrefetchStats()
+{
+    const PrefetchPolicy &prefetch(PrefetchPolicy::instance());
+    debug_text->appendPlainText(QString("Prefetch\thit rate %1% (%2 hits, %3 misses, %4 jumps)")
+            .arg(prefetch.hitRate(), 0, 'f', 1).arg(prefetch.hits()).arg(prefetch.misses()).arg(prefetch.jumps()));
+    debug_text->appendPlainText(QString("\tahead %1, behind %2, %3 ms/page, %4 ms/decode, direction %5")
+            .arg(prefetch.pagesAhead()).arg(prefetch.pagesBehind()).arg(prefetch.msPerPage()).arg(prefetch.decodeMs()).arg(prefetch.direction(), 0, 'f', 2));
+}
+
+void MemoryDebug::appendBufferPoolStats()
+{
+    const ImageBufferPool &pool(ImageBufferPool::instance());
+    debug_text->appendPlainText(QString("Buffers\t%1 allocated, %2 reused, %3 KB spare")
+            .arg(pool.allocations()).arg(pool.reuses()).arg(pool.spareBytes() / 1024));
 }
 
 void MemoryDebug::appendObjectCount(const QString &className, int count, int total)
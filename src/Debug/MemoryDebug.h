@@ -34,6 +34,8 @@ namespace QComicBook
           
         private:
             void appendObjectCount(const QString &className, int count, int total);
+            void appendPrefetchStats();
+            void appendBufferPoolStats();
     };
 }
 
@@ -44,3 +44,33 @@ const ComicFrame& ComicFrameList::operator[](int idx)
 	return m_frames[idx];
 }
 
+
+QDataStream& QComicBook::operator<<(QDataStream &str, const ComicFrame &f)
+{
+	str << qint32(f.xPos()) << qint32(f.yPos()) << qint32(f.width()) << qint32(f.height()) << qint32(f.label());
+	return str;
+}
+
+QDataStream& QComicBook::operator>>(QDataStream &str, ComicFrame &f)
+{
+	qint32 x, y, w, h, lbl;
+	str >> x >> y >> w >> h >> lbl;
+	f = ComicFrame(x, y, w, h, lbl);
+	return str;
+}
+
+QDataStream& QComicBook::operator<<(QDataStream &str, const ComicFrameList &frames)
+{
+	str << qint32(frames.m_page) << qint32(frames.m_pageWidth) << qint32(frames.m_pageHeight) << frames.m_frames;
+	return str;
+}
+
+QDataStream& QComicBook::operator>>(QDataStream &str, ComicFrameList &frames)
+{
+	qint32 page, width, height;
+	str >> page >> width >> height >> frames.m_frames;
+	frames.m_page = page;
+	frames.m_pageWidth = width;
+	frames.m_pageHeight = height;
+	return str;
+}
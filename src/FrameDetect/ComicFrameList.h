@@ -14,6 +14,7 @@
 #define __COMIC_FRAME_LIST_H
 
 #include <QVector>
+#include <QDataStream>
 #include <ComicFrame.h>
 
 namespace QComicBook
@@ -29,6 +30,10 @@ namespace QComicBook
 			const ComicFrame& operator[](int idx);
 			int count() const { return m_frames.count(); }
 			int pageNumber() const { return m_page; }
+			void setPageNumber(int page) { m_page = page; }
+
+			friend QDataStream& operator<<(QDataStream &str, const ComicFrameList &frames);
+			friend QDataStream& operator>>(QDataStream &str, ComicFrameList &frames);
 
 		private:
 			int m_page;
@@ -36,6 +41,11 @@ namespace QComicBook
 			int m_pageHeight;
 			QVector<ComicFrame> m_frames;
 	};
+
+	QDataStream& operator<<(QDataStream &str, const ComicFrame &f);
+	QDataStream& operator>>(QDataStream &str, ComicFrame &f);
+	QDataStream& operator<<(QDataStream &str, const ComicFrameList &frames);
+	QDataStream& operator>>(QDataStream &str, ComicFrameList &frames);
 }
 
 #endif
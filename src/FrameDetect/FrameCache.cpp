@@ -11,9 +11,24 @@
  */
 
 #include <FrameCache.h>
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QHash>
+#include <QMutexLocker>
+#include "../Page.h"
+#include "../ComicBookSettings.h"
+#include "../Utility.h"
+#include "../ContentHash.h"
+#include "../ComicBookDebug.h"
 
 using namespace QComicBook;
 
+const int FrameCache::MAX_PAGES = 1000;
+const qint64 FrameCache::MAX_STORE_SIZE = 4 * 1024 * 1024;
+const quint32 FrameCache::MAGIC = 0x51434652; // "QCFR"
+const quint32 FrameCache::VERSION = 1;
+
 FrameCache& FrameCache::instance()
 {
 	static FrameCache cache;
@@ -21,6 +36,7 @@ FrameCache& FrameCache::instance()
 }
 
 FrameCache::FrameCache()
+	: m_frames(MAX_PAGES)
 {
 }
 
@@ -28,23 +44,191 @@ FrameCache::~FrameCache()
 {
 }
 
-void FrameCache::insert(const ComicFrameList &frames)
+void FrameCache::setComicBook(const QByteArray &key)
 {
-	m_frames[frames.pageNumber()] = frames;
+	const QString dir(ComicBookSettings::instance().framesDir());
+	const QString path((!key.isEmpty() && !dir.isEmpty()) ? dir + "/" + key + ".frm" : QString());
+
+	//
+	// frames of previous comic book are dropped, so that pages of different books never share them
+	m_mtx.lock();
+	if (path == m_storePath)
+	{
+		m_mtx.unlock();
+		return;
+	}
+	m_storePath = path;
+	m_frames.clear();
+	m_mtx.unlock();
+
+	if (path.isEmpty())
+	{
+		return;
+	}
+
+	//
+	// file is read without m_mtx, so frame detection isn't blocked meanwhile
+	m_fileMtx.lock();
+	const QHash<QByteArray, ComicFrameList> frames(load(path));
+	m_fileMtx.unlock();
+
+	QMutexLocker lock(&m_mtx);
+	if (path != m_storePath)
+	{
+		return; // comic book changed meanwhile
+	}
+	for (QHash<QByteArray, ComicFrameList>::const_iterator it = frames.constBegin(); it != frames.constEnd(); ++it)
+	{
+		if (!m_frames.contains(it.key())) // detected meanwhile
+		{
+			m_frames.insert(it.key(), new ComicFrameList(it.value()));
+		}
+	}
 }
 
-bool FrameCache::has(int page) const
+bool FrameCache::get(const Page &page, ComicFrameList &frames)
 {
-	return m_frames.contains(page);
+	const QByteArray key(pageKey(page));
+
+	QMutexLocker lock(&m_mtx);
+	const ComicFrameList *f = m_frames.object(key);
+	if (f)
+	{
+		frames = *f;
+		frames.setPageNumber(page.getNumber()); // same contents may appear under different page number
+		return true;
+	}
+	return false;
 }
 
-ComicFrameList FrameCache::get(int page) const
+void FrameCache::insert(const Page &page, const ComicFrameList &frames)
 {
-	return m_frames[page];
+	const QByteArray key(pageKey(page));
+
+	m_mtx.lock();
+	m_frames.insert(key, new ComicFrameList(frames));
+	const QString path(m_storePath);
+	m_mtx.unlock();
+
+	if (!path.isEmpty())
+	{
+		QMutexLocker lock(&m_fileMtx);
+		save(path, key, frames);
+	}
 }
 
 void FrameCache::clear()
 {
+	QMutexLocker lock(&m_mtx);
 	m_frames.clear();
 }
 
+QHash<QByteArray, ComicFrameList> FrameCache::load(const QString &path)
+{
+	QHash<QByteArray, ComicFrameList> latest; // last record of every page
+
+	QFile f(path);
+	if (!f.open(QIODevice::ReadOnly))
+	{
+		return latest;
+	}
+
+	QDataStream str(&f);
+	str.setVersion(QDataStream::Qt_5_0);
+
+	quint32 magic, version;
+	str >> magic >> version;
+	if (magic != MAGIC || version != VERSION)
+	{
+		_DEBUG << "discarding invalid frames file" << path;
+		f.close();
+		f.remove();
+		return latest;
+	}
+
+	int n = 0;
+	while (!str.atEnd())
+	{
+		QByteArray key;
+		ComicFrameList frames;
+		str >> key >> frames;
+		if (str.status() != QDataStream::Ok)
+		{
+			break; // truncated record, e.g. after a crash
+		}
+		latest.insert(key, frames);
+		++n;
+	}
+	f.close();
+
+	_DEBUG << "loaded frames for" << latest.count() << "pages from" << path;
+
+	//
+	// records are only appended, so pages detected again (e.g. after falling out of memory cache)
+	// are stored more than once; file is rewritten once such duplicates outnumber the pages
+	if (n - latest.count() > latest.count())
+	{
+		_DEBUG << "compacting frames file," << n - latest.count() << "duplicates";
+		write(path, latest);
+	}
+	Utility::touch(path); // mark as recently used for removeLeastRecentlyUsed()
+	return latest;
+}
+
+void FrameCache::write(const QString &path, const QHash<QByteArray, ComicFrameList> &frames)
+{
+	//
+	// new file replaces the old one only when it's complete, so a crash can't lose stored frames
+	QSaveFile f(path);
+	if (!f.open(QIODevice::WriteOnly))
+	{
+		return;
+	}
+
+	QDataStream str(&f);
+	str.setVersion(QDataStream::Qt_5_0);
+	str << MAGIC << VERSION;
+	for (QHash<QByteArray, ComicFrameList>::const_iterator it = frames.constBegin(); it != frames.constEnd(); ++it)
+	{
+		str << it.key() << it.value();
+	}
+	if (str.status() == QDataStream::Ok)
+	{
+		f.commit();
+	}
+	else
+	{
+		f.cancelWriting();
+	}
+}
+
+void FrameCache::save(const QString &path, const QByteArray &key, const ComicFrameList &frames)
+{
+	QFile f(path);
+	if (!f.open(QIODevice::WriteOnly | QIODevice::Append))
+	{
+		return;
+	}
+
+	QDataStream str(&f);
+	str.setVersion(QDataStream::Qt_5_0);
+	if (f.size() == 0)
+	{
+		str << MAGIC << VERSION;
+	}
+	str << key << frames;
+}
+
+void FrameCache::removeLeastRecentlyUsed()
+{
+	Utility::removeLeastRecentlyUsed(ComicBookSettings::instance().framesDir(), "*.frm", MAX_STORE_SIZE);
+}
+
+QByteArray FrameCache::pageKey(const Page &page)
+{
+	//
+	// identifies the page by its contents rather than by its number
+	ContentHash h;
+	h.addImage(page.getImage());
+	return h.result();
+}
@@ -14,11 +14,24 @@
 #define __FRAME_CACHE_H
 
 #include <QObject>
-#include <QMap>
+#include <QCache>
+#include <QMutex>
+#include <QByteArray>
+#include <QHash>
 #include <ComicFrameList.h>
 
 namespace QComicBook
 {
+	class Page;
+
+	//! Cache of detected comic frames.
+	/*! Frames of current comic book are kept in a bounded LRU cache keyed by page
+	 *  contents, so they survive view type changes. Frames detected for a comic book are also
+	 *  appended to a per-comic file in the frames cache directory and loaded
+	 *  back when the comic book is opened again; the file is rewritten on load
+	 *  once it holds more duplicate records than pages.
+	 *  All methods are thread-safe.
+	 */
 	class FrameCache: public QObject
 	{
 		Q_OBJECT
@@ -26,18 +39,48 @@ namespace QComicBook
 		public:
 			static FrameCache& instance();
 
+			//! Selects persistent store for given comic book and loads frames saved there.
+			/*! @param key comic book content identity (see ImgSink::contentKey()); empty key detaches persistent store */
+			void setComicBook(const QByteArray &key);
+
+			//! Looks up frames of given page.
+			/*! @param page decoded page
+			 *  @param frames receives frames, renumbered to page number
+			 *  @return true if frames for this page were found */
+			bool get(const Page &page, ComicFrameList &frames);
+
+			//! Stores frames of given page in memory and in persistent store.
+			void insert(const Page &page, const ComicFrameList &frames);
+
+			//! Removes least recently used persistent stores exceeding frames cache size.
+			static void removeLeastRecentlyUsed();
+
 		public slots:
-			void insert(const ComicFrameList &frames);
-			bool has(int page) const;
-			ComicFrameList get(int page) const;
+			//! Drops all frames kept in memory.
 			void clear();
-		
+
 		private:
 			FrameCache();
 			FrameCache(const FrameCache &);
 			~FrameCache();
 
-			QMap<int, ComicFrameList> m_frames;
+			//! Reads persistent store; compacts it if it holds too many duplicate records.
+			/*! @return last stored frames of every page */
+			static QHash<QByteArray, ComicFrameList> load(const QString &path);
+			//! Replaces persistent store with given frames.
+			static void write(const QString &path, const QHash<QByteArray, ComicFrameList> &frames);
+			static void save(const QString &path, const QByteArray &key, const ComicFrameList &frames);
+			static QByteArray pageKey(const Page &page);
+
+			static const int MAX_PAGES; //!< max number of pages kept in memory
+			static const qint64 MAX_STORE_SIZE; //!< max total size of persistent stores
+			static const quint32 MAGIC;
+			static const quint32 VERSION;
+
+			QCache<QByteArray, ComicFrameList> m_frames;
+			QString m_storePath; //!< persistent store of current comic book
+			QMutex m_mtx; //!< guards m_frames and m_storePath
+			QMutex m_fileMtx; //!< serializes access to persistent stores; never held with m_mtx
 	};
 }
 
@@ -41,7 +41,7 @@ void FrameDetectThread::run()
 		for (;;)
 		{
 			m_processListMtx.lock();
-			if (m_stop)
+			if (m_stop || m_pages.isEmpty())
 			{
 				m_processListMtx.unlock();
 				break;
@@ -53,19 +53,19 @@ void FrameDetectThread::run()
 			_DEBUG << "processing page" << p.getNumber();
 
 			FrameCache &fc(FrameCache::instance());
-			if (fc.has(p.getNumber()))
+			ComicFrameList frames;
+			if (fc.get(p, frames))
 			{
                             _DEBUG << "frames for page" << p.getNumber() << "in cache";
-                            emit framesReady(fc.get(p.getNumber()));
 			}
 			else
 			{
 				FrameDetect fd(p);
-				ComicFrameList frames(fd.process());
-				fc.insert(frames);
+				frames = fd.process();
+				fc.insert(p, frames);
                                 _DEBUG << "num of frames for page" << p.getNumber() << "=" << frames.count();
-				emit framesReady(frames);
 			}
+			emit framesReady(frames);
 
 			m_processListMtx.lock();
 			volatile int n = m_pages.count();
@@ -83,7 +83,6 @@ void FrameDetectThread::clear()
 	m_processListMtx.lock();
 	m_pages.clear();
 	m_processListMtx.unlock();
-	FrameCache::instance().clear();
 }
 
 void FrameDetectThread::process(const Page &p)
@@ -14,10 +14,11 @@
 #include <QPainter>
 #include "../ComicBookDebug.h"
 #include <QImage>
+#include <QMatrix>
 
 using namespace QComicBook;
 
-FrameRedrawJob::FrameRedrawJob(): ImageTransformJob(), m_img(0), m_result(0)
+FrameRedrawJob::FrameRedrawJob(): ImageTransformJob(), m_img(0)
 {
 }
 
@@ -25,7 +26,6 @@ FrameRedrawJob::~FrameRedrawJob()
 {
     _DEBUG;
     delete m_img;
-    delete m_result;
 }
 
 void FrameRedrawJob::setImage(const QImage &img, const QRect &frame)
@@ -35,30 +35,18 @@ void FrameRedrawJob::setImage(const QImage &img, const QRect &frame)
     m_rect = frame;
 }
 
-void FrameRedrawJob::execute()
+bool FrameRedrawJob::isOpaque() const
 {
-    _DEBUG << key();
-
-    delete m_result;
-    m_result = new QImage(m_width, m_height, QImage::Format_ARGB32);
-    m_result->fill(0); // this prevents artifcats/garbage in transparent images
-
-    QPainter p(m_result);
-    p.setRenderHint(QPainter::SmoothPixmapTransform, m_props.smoothScaling);
-
-    p.setWorldMatrix(*m_matrix);
-    p.setWorldMatrixEnabled(true);
-
-    p.drawImage(0, 0, *m_img, m_rect.x(), m_rect.y(), m_rect.width(), m_rect.height());
+    return m_img && !m_img->hasAlphaChannel() && m_img->rect().contains(m_rect) && m_props.background.alpha() == 255;
+}
 
-    p.end();
+QRect FrameRedrawJob::coveredRect() const
+{
+    return innerRect(m_matrix->mapRect(QRectF(QPointF(0, 0), m_rect.size())));
 }
 
-QImage FrameRedrawJob::getResult() const
+void FrameRedrawJob::paint(QPainter &p) const
 {
-    if (m_result)
-    {
-        return *m_result;
-    }
-    return QImage();
+    p.setWorldMatrix(*m_matrix, true);
+    p.drawImage(0, 0, *m_img, m_rect.x(), m_rect.y(), m_rect.width(), m_rect.height());
 }
@@ -25,14 +25,15 @@ namespace QComicBook
         ~FrameRedrawJob();
 
         void setImage(const QImage &img, const QRect &frame);
-        
-        void execute();
-        QImage getResult() const;
+
+    protected:
+        virtual bool isOpaque() const;
+        virtual QRect coveredRect() const;
+        virtual void paint(QPainter &p) const;
 
     private:
         QImage *m_img;
         QRect m_rect;
-        QImage *m_result;
     };
 }
 
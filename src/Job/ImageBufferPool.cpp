@@ -0,0 +1,186 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2011 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+#include "ImageBufferPool.h"
+#include "ComicBookDebug.h"
+#include <cstdlib>
+
+using namespace QComicBook;
+
+namespace
+{
+    //! Buffer starts with its bucket size; header keeps pixels 16 bytes aligned.
+    const int HEADER_SIZE = 16;
+    const int MIN_BUCKET = 4096;
+}
+
+const int ImageBufferPool::MAX_SPARE_BYTES = 64*1024*1024;
+
+ImageBufferPool& ImageBufferPool::instance()
+{
+    static ImageBufferPool pool;
+    return pool;
+}
+
+ImageBufferPool::ImageBufferPool(): m_spareBytes(0), m_allocations(0), m_reuses(0)
+{
+}
+
+ImageBufferPool::~ImageBufferPool()
+{
+    clear();
+}
+
+int ImageBufferPool::bucket(int bytes)
+{
+    //
+    // buckets grow with a quarter of power of two, so buffers waste at most 25%
+    // and images of slightly different sizes (e.g. while resizing) share buffers
+    if (bytes <= MIN_BUCKET)
+    {
+        return MIN_BUCKET;
+    }
+    int top = MIN_BUCKET;
+    while (top <= bytes / 2)
+    {
+        top *= 2;
+    }
+    const int step = top / 4;
+    return (bytes + step - 1) / step * step;
+}
+
+QImage ImageBufferPool::acquire(int width, int height, QImage::Format format)
+{
+    if (width <= 0 || height <= 0)
+    {
+        return QImage();
+    }
+    const int bpl = ((width * QImage::toPixelFormat(format).bitsPerPixel() + 31) / 32) * 4;
+    const int size = bucket(bpl * height);
+
+    uchar *buffer = 0;
+    m_mtx.lock();
+    QMap<int, QList<uchar *> >::iterator it = m_spare.find(size);
+    if (it != m_spare.end())
+    {
+        buffer = it->takeLast();
+        if (it->isEmpty())
+        {
+            m_spare.erase(it);
+        }
+        m_spareBytes -= size;
+        ++m_reuses;
+    }
+    else
+    {
+        ++m_allocations;
+    }
+    m_mtx.unlock();
+
+    if (buffer == 0)
+    {
+        buffer = static_cast<uchar *>(std::malloc(size + HEADER_SIZE));
+        if (buffer == 0)
+        {
+            qWarning() << "cannot allocate image buffer of" << size << "bytes";
+            return QImage();
+        }
+        *reinterpret_cast<int *>(buffer) = size;
+    }
+    return QImage(buffer + HEADER_SIZE, width, height, bpl, format, &ImageBufferPool::release, buffer);
+}
+
+void ImageBufferPool::release(void *buffer)
+{
+    instance().put(static_cast<uchar *>(buffer));
+}
+
+void ImageBufferPool::put(uchar *buffer)
+{
+    const int size = *reinterpret_cast<int *>(buffer);
+    if (size > MAX_SPARE_BYTES)
+    {
+        std::free(buffer);
+        return;
+    }
+
+    QList<uchar *> dropped;
+    m_mtx.lock();
+
+    //
+    // make room by dropping buffers of other sizes first; they are likely
+    // left from before the view was resized
+    QMap<int, QList<uchar *> >::iterator it = m_spare.begin();
+    while (m_spareBytes + size > MAX_SPARE_BYTES && it != m_spare.end())
+    {
+        if (it.key() == size)
+        {
+            ++it;
+            continue;
+        }
+        while (!it->isEmpty() && m_spareBytes + size > MAX_SPARE_BYTES)
+        {
+            dropped.append(it->takeFirst());
+            m_spareBytes -= it.key();
+        }
+        it = it->isEmpty() ? m_spare.erase(it) : it + 1;
+    }
+
+    if (m_spareBytes + size <= MAX_SPARE_BYTES)
+    {
+        m_spare[size].append(buffer);
+        m_spareBytes += size;
+    }
+    else
+    {
+        dropped.append(buffer);
+    }
+    m_mtx.unlock();
+
+    foreach (uchar *b, dropped)
+    {
+        std::free(b);
+    }
+}
+
+void ImageBufferPool::clear()
+{
+    m_mtx.lock();
+    foreach (const QList<uchar *> &buffers, m_spare)
+    {
+        foreach (uchar *b, buffers)
+        {
+            std::free(b);
+        }
+    }
+    m_spare.clear();
+    m_spareBytes = 0;
+    m_mtx.unlock();
+}
+
+int ImageBufferPool::spareBytes() const
+{
+    QMutexLocker l(&m_mtx);
+    return m_spareBytes;
+}
+
+int ImageBufferPool::allocations() const
+{
+    QMutexLocker l(&m_mtx);
+    return m_allocations;
+}
+
+int ImageBufferPool::reuses() const
+{
+    QMutexLocker l(&m_mtx);
+    return m_reuses;
+}
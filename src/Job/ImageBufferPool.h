@@ -0,0 +1,64 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2011 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+#ifndef __IMAGEBUFFERPOOL_H
+#define __IMAGEBUFFERPOOL_H
+
+#include <QImage>
+#include <QMap>
+#include <QList>
+#include <QMutex>
+
+namespace QComicBook
+{
+    //! Recycles pixel buffers of redrawn images.
+    /*! Buffers are grouped in buckets of similar sizes. Images returned by acquire()
+     *  give their buffer back to the pool when the last copy of them is destroyed,
+     *  so results of redraw jobs can be shown without copying them. Thread-safe.
+     */
+    class ImageBufferPool
+    {
+    public:
+        static ImageBufferPool& instance();
+
+        //! Returns image that uses recycled buffer if there is one of matching bucket.
+        /*! Contents of image are undefined. */
+        QImage acquire(int width, int height, QImage::Format format);
+
+        //! Frees all spare buffers.
+        void clear();
+
+        int spareBytes() const;
+        int allocations() const; //!< number of buffers allocated so far
+        int reuses() const; //!< number of acquire() calls served with spare buffer
+
+    private:
+        ImageBufferPool();
+        ImageBufferPool(const ImageBufferPool &);
+        ImageBufferPool& operator=(const ImageBufferPool &);
+        ~ImageBufferPool();
+
+        static int bucket(int bytes);
+        static void release(void *buffer);
+        void put(uchar *buffer);
+
+        static const int MAX_SPARE_BYTES; //!< spare buffers over this limit are freed
+
+        mutable QMutex m_mtx;
+        QMap<int, QList<uchar *> > m_spare; //!< spare buffers by bucket
+        int m_spareBytes;
+        int m_allocations;
+        int m_reuses;
+    };
+}
+
+#endif
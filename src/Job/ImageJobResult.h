@@ -22,9 +22,10 @@ namespace QComicBook
     {
         const JobKey key;
         const QImage image;
+        const int generation; //!< see ImageTransformJob::setGeneration()
 
-        ImageJobResult() {}
-        ImageJobResult(const JobKey &key, const QImage &img): key(key), image(img) {}
+        ImageJobResult(): generation(0) {}
+        ImageJobResult(const JobKey &key, const QImage &img, int generation = 0): key(key), image(img), generation(generation) {}
     };
 }
 
@@ -11,12 +11,85 @@
  */
 
 #include "ImageTransformJob.h"
+#include "ImageBufferPool.h"
 #include "ComicBookDebug.h"
 #include <QMatrix>
+#include <QPainter>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QRegion>
+#include <cmath>
 
 using namespace QComicBook;
 
-ImageTransformJob::ImageTransformJob(): m_matrix(0)
+namespace
+{
+    //! Tiles of one job; shared by the job and its helper tasks.
+    struct TileSet
+    {
+        ImageTransformJob *job;
+        int count;
+        int tileHeight;
+        QAtomicInt next; //!< next tile to take
+        QMutex mtx;
+        QWaitCondition allDone;
+        int done; //!< guarded by mtx
+    };
+
+    //! Takes and paints tiles until there are none left.
+    void paintTiles(TileSet &tiles)
+    {
+        int painted = 0;
+        for (;;)
+        {
+            const int i = tiles.next.fetchAndAddOrdered(1);
+            if (i >= tiles.count)
+            {
+                break;
+            }
+            tiles.job->paintTile(i * tiles.tileHeight, tiles.tileHeight);
+            ++painted;
+        }
+        if (painted > 0)
+        {
+            tiles.mtx.lock();
+            tiles.done += painted;
+            const bool last = tiles.done == tiles.count;
+            tiles.mtx.unlock();
+            if (last)
+            {
+                tiles.allDone.wakeAll();
+            }
+        }
+    }
+
+    //! Helps painting tiles of a job; does nothing if job's thread has already taken all of them.
+    class TileTask: public QRunnable
+    {
+        public:
+            TileTask(const QSharedPointer<TileSet> &tiles): tiles(tiles) {}
+            virtual void run() { paintTiles(*tiles); }
+
+        private:
+            const QSharedPointer<TileSet> tiles; //!< job's thread may be gone by the time task runs
+    };
+
+    QThreadPool* tilesPool()
+    {
+        static QThreadPool pool;
+        return &pool;
+    }
+}
+
+const int ImageTransformJob::MIN_TILE_HEIGHT = 64;
+
+ImageTransformJob::ImageTransformJob(): m_bits(0), m_generation(0), m_matrix(0)
 {
 }
 
@@ -36,6 +109,16 @@ const JobKey& ImageTransformJob::key() const
     return m_key;
 }
 
+void ImageTransformJob::setGeneration(int g)
+{
+    m_generation = g;
+}
+
+int ImageTransformJob::generation() const
+{
+    return m_generation;
+}
+
 void ImageTransformJob::setSize(int w, int h)
 {
     m_width = w;
@@ -52,3 +135,113 @@ void ImageTransformJob::setViewProperties(const ViewPropertiesData &props)
 {
     m_props = props;
 }
+
+void ImageTransformJob::execute()
+{
+    _DEBUG << key();
+    QElapsedTimer timer;
+    timer.start();
+
+    //
+    // both formats are painted without conversions, unlike non-premultiplied ARGB32
+    m_result = ImageBufferPool::instance().acquire(m_width, m_height, isOpaque() ? QImage::Format_RGB32 : QImage::Format_ARGB32_Premultiplied);
+    if (m_result.isNull())
+    {
+        return;
+    }
+
+    //
+    // a few tiles per core, so that cores that finish early can take over
+    const int cores = qMax(1, QThread::idealThreadCount());
+    const int count = qBound(1, m_height / MIN_TILE_HEIGHT, cores * 2);
+
+    QSharedPointer<TileSet> tiles(new TileSet);
+    tiles->job = this;
+    tiles->count = count;
+    tiles->tileHeight = (m_height + count - 1) / count;
+    tiles->done = 0;
+    prepare();
+    m_bits = m_result.bits(); // detaches once here, not in every tile
+
+    for (int i=1; i<qMin(count, cores); i++)
+    {
+        tilesPool()->start(new TileTask(tiles));
+    }
+
+    //
+    // this thread paints tiles as well, so the job completes even if the pool is busy
+    paintTiles(*tiles);
+
+    tiles->mtx.lock();
+    while (tiles->done < tiles->count)
+    {
+        tiles->allDone.wait(&tiles->mtx);
+    }
+    tiles->mtx.unlock();
+
+    _DEBUG << key() << m_width << "x" << m_height << "rendered in" << timer.elapsed() << "ms";
+}
+
+void ImageTransformJob::paintTile(int y, int height)
+{
+    height = qMin(height, m_height - y);
+    if (height <= 0)
+    {
+        return;
+    }
+
+    //
+    // tile is a separate image sharing rows of the result, so that tiles can have their own painters
+    const int bpl = m_result.bytesPerLine();
+    QImage tile(m_bits + y * bpl, m_width, height, bpl, m_result.format());
+    if (m_result.hasAlphaChannel())
+    {
+        tile.fill(0); // this prevents artifcats/garbage in transparent images
+    }
+    else
+    {
+        //
+        // recycled buffer holds previous image; clear only what render() won't overwrite
+        const QRect rows(0, y, m_width, height);
+        const QRegion border(QRegion(rows).subtracted(coveredRect()));
+        if (!border.isEmpty())
+        {
+            QPainter p(&tile);
+            p.translate(0, -y);
+            foreach (const QRect &r, border.rects())
+            {
+                p.fillRect(r, m_props.background);
+            }
+        }
+    }
+    render(tile, y);
+}
+
+QRect ImageTransformJob::innerRect(const QRectF &r)
+{
+    return QRect(QPoint(static_cast<int>(std::ceil(r.left())), static_cast<int>(std::ceil(r.top()))),
+                 QPoint(static_cast<int>(std::floor(r.right())) - 1, static_cast<int>(std::floor(r.bottom())) - 1));
+}
+
+void ImageTransformJob::render(QImage &tile, int y) const
+{
+    QPainter p(&tile);
+    p.setRenderHint(QPainter::SmoothPixmapTransform, m_props.scaling != FastScaling);
+    p.translate(0, -y);
+    p.setClipRect(0, y, m_width, tile.height());
+    paint(p);
+    p.end();
+}
+
+void ImageTransformJob::paintPreview(QPainter &p) const
+{
+    p.save();
+    p.setRenderHint(QPainter::SmoothPixmapTransform, false);
+    paint(p);
+    p.restore();
+}
+
+QImage ImageTransformJob::getResult() const
+{
+    return m_result;
+}
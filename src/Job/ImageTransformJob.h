@@ -16,9 +16,12 @@
 #include "JobKey.h"
 #include "../ViewPropertiesData.h"
 #include "Counted.h"
+#include <QImage>
+
+#include <QRect>
 
-class QImage;
 class QMatrix;
+class QPainter;
 
 namespace QComicBook
 {
@@ -32,14 +35,59 @@ namespace QComicBook
         void setMatrix(const QMatrix &m);
         void setKey(const JobKey &k);
         const JobKey& key() const;
+        //! Sets number telling result of this job from results of earlier jobs of the same key.
+        void setGeneration(int g);
+        int generation() const;
 
         void setViewProperties(const ViewPropertiesData &props);
 
-        virtual void execute() = 0;
-        virtual QImage getResult() const = 0;
+        //! Renders the result.
+        /*! Result is split into horizontal tiles painted in parallel by the
+         *  calling thread and workers of the tiles pool. */
+        void execute();
+        QImage getResult() const;
+
+        //! Paints given rows of the result; used by tiles of execute().
+        void paintTile(int y, int height);
+
+        //! Paints the result with given painter without filtering.
+        /*! Cheap preview shown in place of the result until the job is executed. */
+        void paintPreview(QPainter &p) const;
 
     protected:
+        //! Tells if the result is covered with opaque pixels entirely.
+        /*! Result of opaque job is rendered into recycled Format_RGB32 image that isn't cleared first;
+         *  other jobs render into cleared Format_ARGB32_Premultiplied image. Pixels of opaque result
+         *  outside coveredRect() are filled with opaque background. */
+        virtual bool isOpaque() const { return false; }
+
+        //! Returns pixels of the result that render() certainly overwrites; valid after prepare().
+        virtual QRect coveredRect() const { return QRect(); }
+
+        //! Returns pixels entirely inside given rectangle.
+        static QRect innerRect(const QRectF &r);
+
+        //! Precomputes data shared by tiles; called by execute() before tiles are rendered.
+        virtual void prepare() {}
+
+        //! Renders given rows of the result.
+        /*! Called concurrently, once per tile. Default implementation paints the tile with paint().
+         *  @param tile rows of the result; cleared unless job is opaque
+         *  @param y row of the result first row of tile shows */
+        virtual void render(QImage &tile, int y) const;
+
+        //! Paints the result.
+        /*! Called concurrently, once per tile; each call gets its own painter that is
+         *  clipped to the tile and transformed so that it paints in result coordinates.
+         *  Transformations should be combined with the one already set. */
+        virtual void paint(QPainter &p) const = 0;
+
+        static const int MIN_TILE_HEIGHT; //!< tiles smaller than that cost more to set up than they save
+
+        QImage m_result;
+        uchar *m_bits; //!< pixels of m_result shared by tiles
         JobKey m_key;
+        int m_generation;
         int m_width;
         int m_height;
         ViewPropertiesData m_props; //!< view properties
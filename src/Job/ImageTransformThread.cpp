@@ -14,15 +14,31 @@
 #include "ImageTransformJob.h"
 #include "ImageJobResult.h"
 #include "ComicBookDebug.h"
+#include <QRunnable>
 
 using namespace QComicBook;
 
+namespace
+{
+    class JobTask: public QRunnable
+    {
+        public:
+            JobTask(ImageTransformThread *thread, ImageTransformJob *job): thread(thread), job(job) {}
+            virtual void run() { thread->runJob(job); }
+
+        private:
+            ImageTransformThread *thread;
+            ImageTransformJob *job;
+    };
+}
+
 ImageTransformThread* ImageTransformThread::sm_thread = 0;
 
 ImageTransformThread::ImageTransformThread(): QThread()
 {
     _DEBUG;
     m_stopped = false;
+    m_seq = 0;
 }
 
 ImageTransformThread::~ImageTransformThread()
@@ -36,71 +52,93 @@ void ImageTransformThread::addJob(ImageTransformJob *job)
     if (job)
     {
         m_jobmtx.lock();
-        for (QList<ImageTransformJob *>::iterator it = m_jobs.begin(); it != m_jobs.end(); ++it)
+        const QHash<JobKey, quint64>::const_iterator it = m_index.constFind(job->key());
+        if (it != m_index.constEnd())
         {
-            ImageTransformJob *j = *it;
-            if (j->key() == job->key())
-            {
-                _DEBUG << "removing duplicated job" << job->key();
-                delete j;
-                m_jobs.erase(it);
-                break;
-            }
+            //
+            // newer job takes place of the old one in the queue
+            _DEBUG << "replacing duplicated job" << job->key();
+            ImageTransformJob *&queued = m_queue[it.value()];
+            delete queued;
+            queued = job;
         }
-        m_jobs.append(job);
-        _DEBUG << "num of jobs" << m_jobs.count();
-        m_jobmtx.unlock();
+        else
+        {
+            m_index.insert(job->key(), m_seq);
+            m_queue.insert(m_seq++, job);
+        }
+        _DEBUG << "num of jobs" << m_queue.count();
         m_reqCond.wakeOne();
+        m_jobmtx.unlock();
     }
 }
 
 void ImageTransformThread::run()
 {
     _DEBUG;
-    while (!m_stopped)
+    m_jobmtx.lock();
+    for (;;)
     {
-        m_condMutex.lock();
-        m_reqCond.wait(&m_condMutex);
-        m_condMutex.unlock();
-
-        for (;;)
+        QMap<quint64, ImageTransformJob *>::iterator it;
+        while (!m_stopped && (m_running.count() >= m_pool.maxThreadCount() || (it = nextJob()) == m_queue.end()))
         {
-            m_jobmtx.lock();
-            if (m_jobs.isEmpty())
-            {
-                m_jobmtx.unlock();
-                break;
-            }
-            ImageTransformJob *job = m_jobs.first();
-            _DEBUG << "got new job" << job->key();
-            m_jobs.pop_front();
-            m_jobmtx.unlock();
-
-            job->execute();
-            emit jobCompleted(ImageJobResult(job->key(), job->getResult()));
-            delete job;
+            m_reqCond.wait(&m_jobmtx);
+        }
+        if (m_stopped)
+        {
+            break;
         }
+        ImageTransformJob *job = it.value();
+        m_queue.erase(it);
+        m_index.remove(job->key());
+        _DEBUG << "got new job" << job->key();
+        m_running.insert(job->key());
+        m_pool.start(new JobTask(this, job));
     }
+    m_jobmtx.unlock();
+    m_pool.waitForDone();
+}
+
+QMap<quint64, ImageTransformJob *>::iterator ImageTransformThread::nextJob()
+{
+    QMap<quint64, ImageTransformJob *>::iterator it = m_queue.begin();
+    while (it != m_queue.end() && m_running.contains(it.value()->key()))
+    {
+        ++it;
+    }
+    return it;
+}
+
+void ImageTransformThread::runJob(ImageTransformJob *job)
+{
+    job->execute();
+    emit jobCompleted(ImageJobResult(job->key(), job->getResult(), job->generation()));
+
+    m_jobmtx.lock();
+    m_running.remove(job->key());
+    m_reqCond.wakeOne();
+    m_jobmtx.unlock();
+    delete job;
 }
 
 void ImageTransformThread::cancel()
 {
     _DEBUG;
     m_jobmtx.lock();
-    foreach (ImageTransformJob *job, m_jobs)
-    {
-        delete job;
-    }
-    m_jobs.clear();
+    qDeleteAll(m_queue);
+    m_queue.clear();
+    m_index.clear();
     m_jobmtx.unlock();
 }
 
 void ImageTransformThread::stop()
 {
     _DEBUG;
-    m_stopped = true;
     cancel();
+    m_jobmtx.lock();
+    m_stopped = true;
     m_reqCond.wakeOne();
+    m_jobmtx.unlock();
 }
 
 ImageTransformThread* ImageTransformThread::get()
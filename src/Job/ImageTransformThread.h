@@ -14,15 +14,25 @@
 #define __IMAGETRANSFORMTHREAD_H
 
 #include <QThread>
-#include <QList>
+#include <QMap>
+#include <QHash>
+#include <QSet>
 #include <QMutex>
 #include <QWaitCondition>
+#include <QThreadPool>
+#include "JobKey.h"
 
 namespace QComicBook 
 {
     class ImageTransformJob;
     class ImageJobResult;
 
+    //! Runs image transform jobs.
+    /*! Jobs are dispatched to a pool of workers, so independent jobs run in parallel;
+     *  each job additionally paints its tiles in parallel (see ImageTransformJob::execute()).
+     *  Jobs with the same key never run at the same time, so results come in order
+     *  of requests.
+     */
     class ImageTransformThread: public QThread
     {
         Q_OBJECT
@@ -34,6 +44,9 @@ namespace QComicBook
         static ImageTransformThread* get();
 
         void run();
+
+        //! Executes job on a worker; used by workers pool.
+        void runJob(ImageTransformJob *job);
         
     public slots:
         void stop();
@@ -44,12 +57,19 @@ namespace QComicBook
         void jobCompleted(const ImageJobResult &);
 
     private:
+        //! @return first job that may be started now, m_queue.end() if none
+        /*! Skips only jobs with running keys, at most one per running job. */
+        QMap<quint64, ImageTransformJob *>::iterator nextJob();
+
         QMutex m_jobmtx;
-        QMutex m_condMutex;
-        QWaitCondition m_reqCond;
+        QWaitCondition m_reqCond; //!< signalled when job is added or finished, or thread is stopped; used with m_jobmtx
         bool m_stopped;
                 
-        QList<ImageTransformJob *> m_jobs;
+        QMap<quint64, ImageTransformJob *> m_queue; //!< pending jobs by sequence number, i.e. in order of requests
+        QHash<JobKey, quint64> m_index; //!< sequence numbers of pending jobs, at most one per key
+        quint64 m_seq; //!< sequence number of next new job
+        QSet<JobKey> m_running; //!< keys of jobs being executed; guarded by m_jobmtx
+        QThreadPool m_pool;
         static ImageTransformThread *sm_thread;
     };
 }
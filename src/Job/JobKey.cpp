@@ -11,14 +11,15 @@
  */
 
 #include "JobKey.h"
+#include <QHash>
 
 using namespace QComicBook;
 
-JobKey::JobKey(): m_subsys(-1), m_key(-1)
+JobKey::JobKey(): m_subsys(-1), m_key(-1), m_owner(0)
 {
 }
 
-JobKey::JobKey(int subsystem, int uniqKey): m_subsys(subsystem), m_key(uniqKey)
+JobKey::JobKey(int subsystem, int uniqKey, const void *owner): m_subsys(subsystem), m_key(uniqKey), m_owner(owner)
 {
 }
 
@@ -32,13 +33,23 @@ int JobKey::getKey() const
     return m_key;
 }
 
+const void* JobKey::getOwner() const
+{
+    return m_owner;
+}
+
 bool JobKey::operator==(const JobKey &other) const
 {
-    return m_subsys == other.m_subsys && m_key == other.m_key;
+    return m_subsys == other.m_subsys && m_key == other.m_key && m_owner == other.m_owner;
+}
+
+uint QComicBook::qHash(const JobKey &key)
+{
+    return ::qHash(key.getSubsystem()) ^ (::qHash(key.getKey()) << 8) ^ ::qHash(reinterpret_cast<quintptr>(key.getOwner()));
 }
 
 QDebug operator<<(QDebug dbg, const QComicBook::JobKey &key)
 {
-    dbg.nospace() << key.getSubsystem() << ":" << key.getKey();
+    dbg.nospace() << key.getSubsystem() << ":" << key.getKey() << "@" << key.getOwner();
     return dbg.space();
 }
@@ -21,16 +21,21 @@ namespace QComicBook
     {
     public:
         JobKey();
-        JobKey(int subsystem, int uniqKey);
+        //! @param owner item the result is for; jobs of different owners never replace each other
+        JobKey(int subsystem, int uniqKey, const void *owner = 0);
         int getSubsystem() const;
         int getKey() const;
+        const void* getOwner() const;
    
         bool operator==(const JobKey &other) const;
 
     private:
         int m_subsys;
         int m_key;
+        const void *m_owner;
     };
+
+    uint qHash(const JobKey &key);
 }
 
 QDebug operator<<(QDebug dbg, const QComicBook::JobKey &job);
@@ -13,109 +13,102 @@
 #include <QImage>
 #include <QPainter>
 #include "../ComicBookDebug.h"
-#include <algorithm>
 #include "PageRedrawJob.h"
 #include "../Page.h"
 #include "ComicPageImage.h"
+#include "Resampler.h"
+#include <QMatrix>
 
 using namespace QComicBook;
 
-PageRedrawJob::PageRedrawJob(): ImageTransformJob(), m_result(0)
+PageRedrawJob::PageRedrawJob(): ImageTransformJob(), m_resampler(0)
 {
-    m_image[0] = m_image[1] = 0;
 }
 
 PageRedrawJob::~PageRedrawJob()
 {
     _DEBUG;
-    delete m_result;
-    delete m_image[0];
-    delete m_image[1];
+    delete m_resampler;
 }
 
-void PageRedrawJob::setImage(const Page &p1)
+void PageRedrawJob::setImage(const Page &p)
 {
-    m_image[0] = new QImage(p1.getImage());
-    m_numbers[0] = p1.getNumber();
+    m_image = p.getImage();
 }
 
-void PageRedrawJob::setImage(const Page &p1, const Page &p2)
+bool PageRedrawJob::isOpaque() const
 {
-    m_image[0] = new QImage(p1.getImage());
-    m_image[1] = new QImage(p2.getImage());
-
-    m_numbers[0] = p1.getNumber();
-    m_numbers[1] = p2.getNumber();
+    return !m_image.isNull() && !m_image.hasAlphaChannel() && m_props.background.alpha() == 255;
 }
 
-void PageRedrawJob::execute()
+QRect PageRedrawJob::coveredRect() const
 {
-    _DEBUG;
-
-    delete m_result;
-    m_result = new QImage(m_width, m_height, QImage::Format_ARGB32);
-    m_result->fill(0); // this prevents artifcats/garbage in transparent images
-
-    QPainter p(m_result);
-    p.setRenderHint(QPainter::SmoothPixmapTransform, m_props.smoothScaling);
-
-    p.setWorldMatrix(*m_matrix);
-    p.setWorldMatrixEnabled(true);
+    return m_covered;
+}
 
-    if (m_image[1]) // 2 pages mode
+void PageRedrawJob::prepare()
+{
+    //
+    // resampler scales and turns by right angles; other transformations are left to QPainter.
+    // QMatrix::rotate() is exact for right angles, so the zeros can be compared
+    const QMatrix &m(*m_matrix);
+    m_covered = innerRect(m.mapRect(QRectF(QPointF(0, 0), m_image.size())));
+    int quarter;
+    if (m.m12() == 0.0 && m.m21() == 0.0 && m.m11() > 0.0 && m.m22() > 0.0)
     {
-        const int swap(m_props.mangaMode);
-        // clear areas not covered by page (if pages sizes differ)
-        for (int i=0; i<2; i++)
-        {
-            const int j(i^swap);
-            if (m_image[j]->height() < std::max(m_image[0]->height(), m_image[1]->height()))
-            {
-                p.fillRect(i*m_image[j]->width(), m_image[j]->height(), m_image[j]->width(), m_sourceSize.height() - m_image[j]->height(), m_props.background);
-                break; //only one page may be smaller
-            }
-        }
-
-        p.drawImage(0, 0, *m_image[0^swap], 0, 0);
-        p.drawImage(m_image[0^swap]->width(), 0, *m_image[1^swap], 0, 0);
-        if (m_props.pageNumbers)
-        {
-            p.setWorldMatrixEnabled(false);
-            drawPageNumber(std::max(m_numbers[swap], m_numbers[1^swap]), p, m_width, m_height);
-        }
+        quarter = 0;
     }
-    else // 1 page mode
+    else if (m.m11() == 0.0 && m.m22() == 0.0 && m.m12() > 0.0 && m.m21() < 0.0)
     {
-        p.drawImage(0, 0, *m_image[0], 0, 0);
-        if (m_props.pageNumbers)
-        {
-            p.setWorldMatrixEnabled(false);
-            drawPageNumber(m_numbers[0], p, m_width, m_height);
-        }
+        quarter = 1;
     }
-    p.end();
-}
+    else if (m.m12() == 0.0 && m.m21() == 0.0 && m.m11() < 0.0 && m.m22() < 0.0)
+    {
+        quarter = 2;
+    }
+    else if (m.m11() == 0.0 && m.m22() == 0.0 && m.m12() < 0.0 && m.m21() > 0.0)
+    {
+        quarter = 3;
+    }
+    else
+    {
+        return;
+    }
+    const double scale = qMin(qAbs(m.m11() + m.m12()), qAbs(m.m21() + m.m22())); // one of each pair is 0
+    const Resampler::Method method = Resampler::choose(scale, m_props.scaling, quarter != 0);
+    if (method == Resampler::Painter)
+    {
+        return;
+    }
+    _DEBUG << "resampling with method" << method << "turned by" << quarter * 90;
 
-void PageRedrawJob::drawPageNumber(int page, QPainter &p, int x, int y)
-{
-    const QString pagestr(QString::number(page + 1));
-    const QFontMetrics mtr(p.fontMetrics());
-    const int txtw(mtr.width(pagestr));
-    p.setPen(Qt::black);
-    p.fillRect(x - txtw - 5, y - 2 - mtr.height(), txtw + 5, mtr.height() + 4, Qt::white);
-    p.drawText(x - txtw - 4, y - 4, pagestr);
+    //
+    // page larger than the result is scaled as a whole and cropped by scaleRows()
+    m_rect = mapRect(m, QRectF(QPointF(0, 0), m_image.size()));
+    m_resampler = new Resampler(m_image, m_rect.width(), m_rect.height(), method, quarter);
+    m_covered = m_rect;
 }
 
-void PageRedrawJob::setSourceSize(const QSize &size)
+QRect PageRedrawJob::mapRect(const QMatrix &m, const QRectF &r)
 {
-    m_sourceSize = size;
+    const QRectF mr(m.mapRect(r));
+    return QRect(QPoint(qRound(mr.left()), qRound(mr.top())), QPoint(qRound(mr.right()) - 1, qRound(mr.bottom()) - 1));
 }
 
-QImage PageRedrawJob::getResult() const
+void PageRedrawJob::render(QImage &tile, int y) const
 {
-    if (m_result)
+    if (m_resampler == 0)
     {
-        return *m_result;
+        ImageTransformJob::render(tile, y);
+        return;
     }
-    return QImage();
+    m_resampler->scaleRows(tile, m_rect.x(), y - m_rect.y());
+}
+
+void PageRedrawJob::paint(QPainter &p) const
+{
+    p.save();
+    p.setWorldMatrix(*m_matrix, true);
+    p.drawImage(0, 0, m_image);
+    p.restore();
 }
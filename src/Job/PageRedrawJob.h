@@ -14,34 +14,41 @@
 #define __PAGEREDRAWJOB_H
 
 #include "ImageTransformJob.h"
-
-class QImage;
+#include <QImage>
+#include <QRect>
 
 namespace QComicBook
 {
     class Page;
+    class Resampler;
 
+    //! Scales and turns one page; pages of a spread are redrawn by separate jobs.
     class PageRedrawJob: public ImageTransformJob
     {
     public:
         PageRedrawJob();
         ~PageRedrawJob();
 
-        void setImage(const Page &p1);
-        void setImage(const Page &p1, const Page &p2);
-        void setSourceSize(const QSize &size);
+        void setImage(const Page &p);
 
-        void execute();
-        QImage getResult() const;
+        //! Maps rectangle of page to rectangle of result.
+        /*! Edges are rounded, not the size, so that adjacent pages stay adjacent. */
+        static QRect mapRect(const QMatrix &m, const QRectF &r);
 
     protected:
-        void drawPageNumber(int page, QPainter &p, int x, int y);
+        //! Page without alpha channel covers the result; rounded edges are filled with background.
+        virtual bool isOpaque() const;
+        virtual QRect coveredRect() const;
+        //! Sets up resampler if page is only scaled and turned by right angles, and view quality asks for it.
+        virtual void prepare();
+        virtual void render(QImage &tile, int y) const;
+        virtual void paint(QPainter &p) const;
 
     private:
-        QImage *m_image[2];
-        int m_numbers[2];  //!< page numbers
-        QImage *m_result; //!< resulting image
-        QSize m_sourceSize;
+        QImage m_image;
+        Resampler *m_resampler; //!< scales page in place of QPainter if set
+        QRect m_rect; //!< resampled page in coordinates of result; may extend beyond it
+        QRect m_covered; //!< pixels of result painted over by page
     };
 }
 
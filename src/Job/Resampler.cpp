@@ -0,0 +1,409 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2011 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+#include "Resampler.h"
+#include <QtGlobal>
+#include <cmath>
+#include <cstring>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace QComicBook;
+
+namespace
+{
+    const double LANCZOS_RADIUS = 3.0;
+    const double BILINEAR_LIMIT = 0.5; //!< QPainter's bilinear filter aliases below this scale
+    const double LANCZOS_LIMIT = 0.25; //!< below this scale Lanczos taps get expensive and area-averaging is as good
+    const double BILINEAR_RADIUS = 1.0;
+
+    double lanczos(double x)
+    {
+        if (x == 0.0)
+        {
+            return 1.0;
+        }
+        if (x <= -LANCZOS_RADIUS || x >= LANCZOS_RADIUS)
+        {
+            return 0.0;
+        }
+        const double px = M_PI * x;
+        return LANCZOS_RADIUS * std::sin(px) * std::sin(px / LANCZOS_RADIUS) / (px * px);
+    }
+
+    //! acc += row * w
+    inline void accumulate(float *acc, const float *row, float w, int n)
+    {
+        int i = 0;
+#if defined(__AVX2__)
+        const __m256 w8 = _mm256_set1_ps(w);
+        for (; i + 8 <= n; i += 8)
+        {
+            _mm256_storeu_ps(acc + i, _mm256_add_ps(_mm256_loadu_ps(acc + i), _mm256_mul_ps(_mm256_loadu_ps(row + i), w8)));
+        }
+#endif
+#if defined(__SSE2__)
+        const __m128 w4 = _mm_set1_ps(w);
+        for (; i + 4 <= n; i += 4)
+        {
+            _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_mul_ps(_mm_loadu_ps(row + i), w4)));
+        }
+#endif
+        for (; i < n; i++)
+        {
+            acc[i] += row[i] * w;
+        }
+    }
+
+    //! Rounds and saturates 4 channels per pixel back to 32 bit pixels.
+    inline void storeRow(const float *acc, QRgb *dst, int width)
+    {
+        int i = 0;
+#if defined(__SSE2__)
+        for (; i + 4 <= width; i += 4)
+        {
+            const float *a = acc + 4*i;
+            const __m128i lo = _mm_packs_epi32(_mm_cvtps_epi32(_mm_loadu_ps(a)), _mm_cvtps_epi32(_mm_loadu_ps(a + 4)));
+            const __m128i hi = _mm_packs_epi32(_mm_cvtps_epi32(_mm_loadu_ps(a + 8)), _mm_cvtps_epi32(_mm_loadu_ps(a + 12)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+        }
+        for (; i < width; i++)
+        {
+            __m128i p = _mm_cvtps_epi32(_mm_loadu_ps(acc + 4*i));
+            p = _mm_packs_epi32(p, p);
+            dst[i] = _mm_cvtsi128_si32(_mm_packus_epi16(p, p));
+        }
+#else
+        for (; i < width; i++)
+        {
+            QRgb p = 0;
+            for (int c=0; c<4; c++)
+            {
+                p |= static_cast<QRgb>(qBound(0, qRound(acc[4*i + c]), 255)) << (8*c);
+            }
+            dst[i] = p;
+        }
+#endif
+    }
+}
+
+const int Resampler::BLOCK_ROWS = 16; // 64 bytes of 32 bit pixels per source line, one cache line
+
+Resampler::Method Resampler::choose(double scale, ScalingQuality quality, bool rotated)
+{
+    //
+    // QPainter has fast paths for nearest-neighbour scaling and for unscaled right angle rotation
+    if (quality == FastScaling || qFuzzyCompare(scale, 1.0))
+    {
+        return Painter;
+    }
+    if (quality == SmoothScaling)
+    {
+        if (scale < BILINEAR_LIMIT)
+        {
+            return AreaAverage;
+        }
+        return rotated ? Bilinear : Painter;
+    }
+    return scale < LANCZOS_LIMIT ? AreaAverage : Lanczos3;
+}
+
+Resampler::Resampler(const QImage &src, int width, int height, Method method, int quarter)
+    : m_src(src)
+    , m_premultiplied(src.hasAlphaChannel())
+    , m_quarter(quarter & 3)
+    , m_srcWidth((quarter & 1) ? src.height() : src.width())
+    , m_srcHeight((quarter & 1) ? src.width() : src.height())
+    , m_width(width)
+    , m_height(height)
+    , m_method(method)
+{
+    switch (m_src.format())
+    {
+        case QImage::Format_Grayscale8:
+            m_colors.resize(256);
+            for (int i=0; i<256; i++)
+            {
+                m_colors[i] = qRgb(i, i, i);
+            }
+            break;
+        case QImage::Format_Mono:
+        case QImage::Format_MonoLSB:
+            m_src = m_src.convertToFormat(QImage::Format_Indexed8);
+            // fall through
+        case QImage::Format_Indexed8:
+            m_colors = m_src.colorTable();
+            m_colors.resize(256); // pixels out of the table are transparent black, as in QImage::pixel()
+            for (int i=0; i<m_colors.count(); i++)
+            {
+                m_colors[i] = qPremultiply(m_colors[i]);
+            }
+            break;
+        default:
+            m_src = m_src.convertToFormat(m_premultiplied ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32);
+            break;
+    }
+    if (m_src.isNull() || m_width <= 0 || m_height <= 0)
+    {
+        m_width = m_height = 0;
+        return;
+    }
+    makeFilter(m_horizontal, m_srcWidth, m_width, method);
+    makeFilter(m_vertical, m_srcHeight, m_height, method);
+}
+
+Resampler::~Resampler()
+{
+}
+
+int Resampler::width() const
+{
+    return m_width;
+}
+
+int Resampler::height() const
+{
+    return m_height;
+}
+
+Resampler::Method Resampler::method() const
+{
+    return m_method;
+}
+
+void Resampler::makeFilter(Filter &f, int srcSize, int dstSize, Method method)
+{
+    const double scale = static_cast<double>(dstSize) / srcSize;
+
+    //
+    // when downscaling, filter is stretched so that it covers all source pixels of result pixel
+    const double fscale = qMin(scale, 1.0);
+    double radius = 0.5 / scale;
+    if (method == Lanczos3)
+    {
+        radius = LANCZOS_RADIUS / fscale;
+    }
+    else if (method == Bilinear)
+    {
+        radius = BILINEAR_RADIUS / fscale;
+    }
+    f.taps = static_cast<int>(std::ceil(2.0 * radius)) + 2;
+    f.first.resize(dstSize);
+    f.count.resize(dstSize);
+    f.weights.fill(0.0f, dstSize * f.taps);
+
+    for (int i=0; i<dstSize; i++)
+    {
+        const double center = (i + 0.5) / scale;
+        const int start = qMax(0, static_cast<int>(std::floor(center - radius)));
+        const int end = qMin(qMin(srcSize, static_cast<int>(std::ceil(center + radius))), start + f.taps);
+
+        float *w = f.weights.data() + i*f.taps;
+        double sum = 0.0;
+        for (int j=start; j<end; j++)
+        {
+            double v;
+            if (method == Lanczos3)
+            {
+                v = lanczos((j + 0.5 - center) * fscale);
+            }
+            else if (method == Bilinear)
+            {
+                v = qMax(0.0, BILINEAR_RADIUS - std::fabs((j + 0.5 - center) * fscale));
+            }
+            else // overlap of source pixel with area of result pixel
+            {
+                v = qMin(center + radius, j + 1.0) - qMax(center - radius, static_cast<double>(j));
+                v = qMax(v, 0.0);
+            }
+            w[j - start] = v;
+            sum += v;
+        }
+
+        f.first[i] = start;
+        f.count[i] = end - start;
+        if (sum != 0.0)
+        {
+            for (int j=0; j<end - start; j++)
+            {
+                w[j] /= sum;
+            }
+        }
+        else
+        {
+            w[0] = 1.0f;
+            f.count[i] = 1;
+        }
+    }
+}
+
+inline QRgb Resampler::pixel(const uchar *line, int x) const
+{
+    return m_colors.isEmpty() ? reinterpret_cast<const QRgb *>(line)[x] : m_colors.constData()[line[x]];
+}
+
+const QRgb* Resampler::sourceRow(int row, QRgb *block, int &blockStart) const
+{
+    if (m_quarter & 1)
+    {
+        if (blockStart < 0 || row < blockStart || row >= blockStart + BLOCK_ROWS)
+        {
+            blockStart = row - row % BLOCK_ROWS;
+            gatherColumns(blockStart, qMin(BLOCK_ROWS, m_srcHeight - blockStart), block);
+        }
+        return block + (row - blockStart) * m_srcWidth;
+    }
+
+    const uchar *line = m_src.constScanLine(m_quarter ? m_src.height() - 1 - row : row);
+    if (m_quarter == 0 && m_colors.isEmpty())
+    {
+        return reinterpret_cast<const QRgb *>(line);
+    }
+    //
+    // 8 bit sources stay compact; only rows being filtered are expanded
+    const int w = m_src.width();
+    if (m_quarter == 0)
+    {
+        for (int i=0; i<w; i++)
+        {
+            block[i] = pixel(line, i);
+        }
+    }
+    else // upside down
+    {
+        for (int i=0; i<w; i++)
+        {
+            block[i] = pixel(line, w - 1 - i);
+        }
+    }
+    return block;
+}
+
+void Resampler::gatherColumns(int first, int count, QRgb *block) const
+{
+    //
+    // reading a column pixel by pixel would touch a cache line per pixel; instead every
+    // source line is read once per block, count adjacent pixels at a time
+    const int h = m_src.height();
+    const bool right = m_quarter == 1;
+    const int left = right ? first : m_src.width() - first - count; // leftmost column of block
+    for (int y=0; y<h; y++)
+    {
+        const uchar *line = m_src.constScanLine(y);
+        QRgb *out = block + (right ? h - 1 - y : y);
+        for (int k=0; k<count; k++)
+        {
+            out[k * m_srcWidth] = pixel(line, right ? left + k : left + count - 1 - k);
+        }
+    }
+}
+
+void Resampler::filterRow(const QRgb *src, float *out, int left, int right) const
+{
+    const int taps = m_horizontal.taps;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+#endif
+
+    for (int i=left; i<right; i++)
+    {
+        const QRgb *s = src + m_horizontal.first[i];
+        const float *w = m_horizontal.weights.constData() + i*taps;
+        const int n = m_horizontal.count[i];
+#if defined(__SSE2__)
+        __m128 acc = _mm_setzero_ps();
+        for (int k=0; k<n; k++)
+        {
+            __m128i px = _mm_cvtsi32_si128(s[k]);
+            px = _mm_unpacklo_epi16(_mm_unpacklo_epi8(px, zero), zero);
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_cvtepi32_ps(px), _mm_set1_ps(w[k])));
+        }
+        _mm_storeu_ps(out + 4*(i - left), acc);
+#else
+        float acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        for (int k=0; k<n; k++)
+        {
+            for (int c=0; c<4; c++)
+            {
+                acc[c] += w[k] * ((s[k] >> (8*c)) & 0xff);
+            }
+        }
+        std::memcpy(out + 4*(i - left), acc, sizeof(acc));
+#endif
+    }
+}
+
+void Resampler::scaleRows(QImage &dst, int x, int first) const
+{
+    const int begin = qMax(0, first);
+    const int end = qMin(m_height, first + dst.height());
+    const int left = qMax(0, -x); // columns of scaled image that fall into dst
+    const int right = qMin(m_width, dst.width() - x);
+    const int width = right - left;
+    if (begin >= end || width <= 0)
+    {
+        return;
+    }
+
+    const bool premultiplied = m_premultiplied;
+    const bool unpremultiply = premultiplied && dst.format() == QImage::Format_ARGB32;
+
+    //
+    // horizontally filtered source rows are kept in a ring buffer; windows of
+    // consecutive result rows only move forward, so every source row is filtered once
+    const int stride = 4 * width;
+    const int slots = m_vertical.taps;
+    QVector<float> rows(slots * stride);
+    QVector<int> rowInSlot(slots, -1);
+    QVector<float> acc(stride);
+    QVector<QRgb> block((m_quarter & 1) ? BLOCK_ROWS * m_srcWidth : m_srcWidth);
+    int blockStart = -1;
+
+    for (int y=begin; y<end; y++)
+    {
+        const int top = m_vertical.first[y];
+        const float *w = m_vertical.weights.constData() + y*slots;
+
+        std::memset(acc.data(), 0, stride * sizeof(float));
+        for (int k=0; k<m_vertical.count[y]; k++)
+        {
+            const int row = top + k;
+            const int slot = row % slots;
+            float *filtered = rows.data() + slot*stride;
+            if (rowInSlot[slot] != row)
+            {
+                filterRow(sourceRow(row, block.data(), blockStart), filtered, left, right);
+                rowInSlot[slot] = row;
+            }
+            accumulate(acc.data(), filtered, w[k], 4*width);
+        }
+
+        QRgb *d = reinterpret_cast<QRgb *>(dst.scanLine(y - first)) + x + left;
+        storeRow(acc.constData(), d, width);
+
+        if (premultiplied)
+        {
+            //
+            // Lanczos lobes may overshoot alpha, which premultiplied pixels must not
+            for (int i=0; i<width; i++)
+            {
+                const QRgb p = d[i];
+                const int a = qAlpha(p);
+                const QRgb q = qRgba(qMin(qRed(p), a), qMin(qGreen(p), a), qMin(qBlue(p), a), a);
+                d[i] = unpremultiply ? qUnpremultiply(q) : q;
+            }
+        }
+    }
+}
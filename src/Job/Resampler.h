@@ -0,0 +1,103 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2011 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+#ifndef __RESAMPLER_H
+#define __RESAMPLER_H
+
+#include "../ViewPropertiesData.h"
+#include <QImage>
+#include <QVector>
+
+namespace QComicBook
+{
+    //! Scales images with area-averaging, bilinear or Lanczos-3 filter, optionally turning them by right angles.
+    /*! Image is filtered horizontally and then vertically. Filter weights are computed
+     *  once by the constructor, so scaleRows() may be called concurrently for different
+     *  rows of the result. Uses SSE2 (and AVX2 if enabled at build time) when available.
+     *  Rotation is done while reading source rows, so rotated images cost about as much
+     *  as unrotated ones. */
+    class Resampler
+    {
+    public:
+        enum Method { Painter, AreaAverage, Bilinear, Lanczos3 };
+
+        //! Chooses scaling method for given scale factor.
+        /*! @param scale scale factor, less than 1 for downscaling
+         *  @param quality scaling quality set in view properties
+         *  @param rotated true if image is also turned by right angle; QPainter is slow at that
+         *  @return method; Painter if image should rather be drawn by QPainter */
+        static Method choose(double scale, ScalingQuality quality, bool rotated = false);
+
+        //! Prepares scaling of image.
+        /*! @param src source image; Format_Grayscale8 and Format_Indexed8 images are expanded
+         *             row by row while scaling, other formats are converted to 32 bits first
+         *  @param width width of scaled image
+         *  @param height height of scaled image
+         *  @param method AreaAverage, Bilinear or Lanczos3
+         *  @param quarter number of clockwise quarter turns applied to source before scaling */
+        Resampler(const QImage &src, int width, int height, Method method, int quarter = 0);
+        ~Resampler();
+
+        int width() const;
+        int height() const;
+        Method method() const;
+
+        //! Writes rows of scaled image.
+        /*! Only the part of scaled image that falls into dst is computed, so scaled image
+         *  may be larger than dst and placed anywhere over it.
+         *  @param dst destination image; Format_RGB32, Format_ARGB32 or Format_ARGB32_Premultiplied
+         *  @param x column of dst the scaled image starts at; may be negative
+         *  @param first row of scaled image written to first row of dst
+         */
+        void scaleRows(QImage &dst, int x, int first) const;
+
+    private:
+        //! Weights of source pixels contributing to each pixel of result along one axis.
+        struct Filter
+        {
+            QVector<int> first; //!< first contributing source pixel
+            QVector<int> count; //!< number of contributing source pixels
+            QVector<float> weights; //!< taps weights for every result pixel
+            int taps; //!< max number of contributing pixels; stride of weights
+        };
+
+        static void makeFilter(Filter &f, int srcSize, int dstSize, Method method);
+        //! Returns row of rotated source; expands or gathers it into block if needed.
+        /*! @param block buffer of BLOCK_ROWS rows of rotated source
+         *  @param blockStart first row gathered in block, -1 if none */
+        const QRgb* sourceRow(int row, QRgb *block, int &blockStart) const;
+        //! Gathers rows of source turned by odd number of quarters, which are source columns.
+        void gatherColumns(int first, int count, QRgb *block) const;
+        inline QRgb pixel(const uchar *line, int x) const;
+        //! Filters columns [left, right) of scaled image from row of rotated source.
+        void filterRow(const QRgb *src, float *out, int left, int right) const;
+
+        static const int BLOCK_ROWS; //!< rows gathered at once from columns of source
+
+        QImage m_src; //!< RGB32, ARGB32_Premultiplied, Grayscale8 or Indexed8
+        QVector<QRgb> m_colors; //!< premultiplied color table of 8 bit source
+        bool m_premultiplied; //!< source has alpha
+        int m_quarter; //!< clockwise quarter turns of source
+        int m_srcWidth; //!< width of rotated source
+        int m_srcHeight; //!< height of rotated source
+        int m_width;
+        int m_height;
+        Method m_method;
+        Filter m_horizontal;
+        Filter m_vertical;
+
+        Resampler(const Resampler &);
+        Resampler& operator=(const Resampler &);
+    };
+}
+
+#endif
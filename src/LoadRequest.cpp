@@ -0,0 +1,176 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2010 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+#include "LoadRequest.h"
+#include <QElapsedTimer>
+
+using namespace QComicBook;
+
+LoadRequest::LoadRequest(int page, bool twoPages, int priority)
+    : pageNumber(page)
+    , twoPages(twoPages)
+    , priority(priority)
+    , queued(now())
+    , generation(0)
+{
+    deadline = queued + budget(priority);
+}
+
+qint64 LoadRequest::budget(int priority)
+{
+    switch (priority)
+    {
+        case PriorityVisible: return 0;
+        case PriorityPreload: return 1000;
+        case PriorityThumbnail: return 5000;
+        default: break;
+    }
+    return 30000;
+}
+
+qint64 LoadRequest::now()
+{
+    static QElapsedTimer timer;
+    static bool started = (timer.start(), true);
+    Q_UNUSED(started);
+    return timer.elapsed();
+}
+
+bool LoadRequestQueue::Key::operator<(const Key &k) const
+{
+    if (priority != k.priority)
+        return priority < k.priority;
+    if (deadline != k.deadline)
+        return deadline < k.deadline;
+    return seq < k.seq;
+}
+
+LoadRequestQueue::LoadRequestQueue()
+    : m_seq(0)
+{
+}
+
+LoadRequestQueue::Key LoadRequestQueue::makeKey(int priority, qint64 deadline)
+{
+    Key key;
+    key.priority = priority;
+    key.deadline = deadline;
+    key.seq = m_seq++;
+    return key;
+}
+
+bool LoadRequestQueue::push(const LoadRequest &req)
+{
+    const int rid = id(req.pageNumber, req.twoPages);
+    const QMap<int, Key>::const_iterator it = m_index.constFind(rid);
+    if (it != m_index.constEnd())
+    {
+        const Key &old = it.value();
+        if (req.priority < old.priority || (req.priority == old.priority && req.deadline < old.deadline))
+        {
+            reschedule(req.pageNumber, req.twoPages, req.priority, req.deadline);
+        }
+        return false;
+    }
+    const Key key(makeKey(req.priority, req.deadline));
+    m_queue.insert(key, req);
+    m_index.insert(rid, key);
+    return true;
+}
+
+bool LoadRequestQueue::reschedule(int page, bool twoPages, int priority, qint64 deadline)
+{
+    const int rid = id(page, twoPages);
+    const QMap<int, Key>::iterator it = m_index.find(rid);
+    if (it == m_index.end())
+    {
+        return false;
+    }
+    LoadRequest req(m_queue.take(it.value()));
+    req.priority = priority;
+    req.deadline = deadline;
+    const Key key(makeKey(priority, deadline));
+    m_queue.insert(key, req);
+    it.value() = key;
+    return true;
+}
+
+bool LoadRequestQueue::remove(int page, bool twoPages)
+{
+    const int rid = id(page, twoPages);
+    const QMap<int, Key>::iterator it = m_index.find(rid);
+    if (it == m_index.end())
+    {
+        return false;
+    }
+    m_queue.remove(it.value());
+    m_index.erase(it);
+    return true;
+}
+
+bool LoadRequestQueue::contains(int page, bool twoPages) const
+{
+    return m_index.contains(id(page, twoPages));
+}
+
+LoadRequest LoadRequestQueue::pop()
+{
+    const QMap<Key, LoadRequest>::iterator it = m_queue.begin();
+    const LoadRequest req(it.value());
+    m_queue.erase(it);
+    m_index.remove(id(req.pageNumber, req.twoPages));
+    return req;
+}
+
+LoadRequest LoadRequestQueue::take(int page, bool twoPages)
+{
+    return m_queue.take(m_index.take(id(page, twoPages)));
+}
+
+const LoadRequest& LoadRequestQueue::first() const
+{
+    return m_queue.constBegin().value();
+}
+
+bool LoadRequestQueue::findAfter(int page, LoadRequest &req) const
+{
+    const QMap<int, Key>::const_iterator it = m_index.lowerBound(id(page, false));
+    if (it == m_index.constEnd())
+    {
+        return false;
+    }
+    req = m_queue.value(it.value());
+    return true;
+}
+
+bool LoadRequestQueue::findBefore(int page, LoadRequest &req) const
+{
+    QMap<int, Key>::const_iterator it = m_index.lowerBound(id(page, false));
+    if (it == m_index.constBegin())
+    {
+        return false;
+    }
+    --it;
+    req = m_queue.value(it.value());
+    return true;
+}
+
+QList<LoadRequest> LoadRequestQueue::requests() const
+{
+    return m_queue.values();
+}
+
+void LoadRequestQueue::clear()
+{
+    m_queue.clear();
+    m_index.clear();
+}
@@ -0,0 +1,120 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2010 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+/*! \file LoadRequest.h */
+
+#ifndef __LOADREQUEST_H
+#define __LOADREQUEST_H
+
+#include <QMap>
+#include <QList>
+#include "Sink/CancellationToken.h"
+
+namespace QComicBook
+{
+    //! Priorities of page load requests, most urgent first.
+    enum LoadPriority
+    {
+        PriorityVisible = 0, //!< page is shown right now
+        PriorityPreload,     //!< page will likely be shown soon
+        PriorityThumbnail,   //!< thumbnail of a page
+        PriorityBackground   //!< anything else
+    };
+
+    struct LoadRequest
+    {
+        int pageNumber;
+        bool twoPages;
+        int priority; //!< one of LoadPriority
+        qint64 deadline; //!< time (see now()) by which request should be served; orders requests of equal priority
+        qint64 queued; //!< time request was queued at
+        CancellationToken token; //!< cancelled when request is cancelled while being processed
+        int generation; //!< generation of loader's sink request was made for
+        
+        LoadRequest(int page=-1, bool twoPages=false, int priority=PriorityBackground);
+        bool operator==(const LoadRequest &r) const
+        {
+            return pageNumber == r.pageNumber && twoPages == r.twoPages;
+        }
+
+        //! @return number identifying requested page(s)
+        int id() const { return id(pageNumber, twoPages); }
+        static int id(int page, bool twoPages) { return page * 2 + (twoPages ? 1 : 0); }
+
+        //! @return default time (in miliseconds) to serve request of given priority
+        static qint64 budget(int priority);
+        //! @return monotonic time in miliseconds
+        static qint64 now();
+    };
+
+    //! Queue of load requests ordered by priority, then deadline, then arrival.
+    /*! Lookup and removal of queued requests by page don't scan the queue. Not thread-safe.
+     */
+    class LoadRequestQueue
+    {
+        public:
+            LoadRequestQueue();
+
+            //! Queues request.
+            /*! If the same page is already queued, it keeps the more urgent of both schedules.
+             *  @return false if request was already queued */
+            bool push(const LoadRequest &req);
+
+            //! Changes priority and deadline of queued request.
+            /*! @return false if request isn't queued */
+            bool reschedule(int page, bool twoPages, int priority, qint64 deadline);
+
+            bool remove(int page, bool twoPages);
+            bool contains(int page, bool twoPages) const;
+
+            //! Removes and returns most urgent request; queue must not be empty.
+            LoadRequest pop();
+
+            //! Removes and returns queued request; it must be queued.
+            LoadRequest take(int page, bool twoPages);
+
+            //! @return most urgent request; queue must not be empty
+            const LoadRequest& first() const;
+
+            //! Finds request of the nearest queued page at or after given one.
+            /*! @return false if there is none */
+            bool findAfter(int page, LoadRequest &req) const;
+            //! Finds request of the nearest queued page before given one.
+            /*! @return false if there is none */
+            bool findBefore(int page, LoadRequest &req) const;
+
+            //! @return queued requests, most urgent first
+            QList<LoadRequest> requests() const;
+
+            bool isEmpty() const { return m_queue.isEmpty(); }
+            int count() const { return m_queue.count(); }
+            void clear();
+
+        private:
+            struct Key
+            {
+                int priority;
+                qint64 deadline;
+                quint64 seq;
+                bool operator<(const Key &k) const;
+            };
+
+            static int id(int page, bool twoPages) { return LoadRequest::id(page, twoPages); }
+            Key makeKey(int priority, qint64 deadline);
+
+            QMap<Key, LoadRequest> m_queue;
+            QMap<int, Key> m_index; //!< keys of queued requests by id(), i.e. in page order
+            quint64 m_seq;
+    };
+}
+
+#endif
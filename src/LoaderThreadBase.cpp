@@ -16,8 +16,31 @@
 #include "ComicBookDebug.h"
 
 using namespace QComicBook;
-LoaderThreadBase::LoaderThreadBase(): QThread(), prio(QThread::LowPriority), sink(NULL), stopped(false)
+
+namespace
 {
+    //! Processes single request on a worker of loader's pool.
+    class LoaderTask: public QRunnable
+    {
+        public:
+            LoaderTask(LoaderThreadBase *loader, const LoadRequest &req, const QSharedPointer<ImgSink> &sink): loader(loader), req(req), sink(sink) {}
+            virtual void run() { loader->runTask(req, sink); }
+
+        private:
+            LoaderThreadBase *loader;
+            const LoadRequest req;
+            const QSharedPointer<ImgSink> sink; //!< keeps sink alive until request is processed
+    };
+}
+
+LoaderThreadBase::LoaderThreadBase(): QThread(), prio(QThread::LowPriority), sink(NULL), generation(0), stopped(false), workers(1), active(0), defaultPriority(PriorityVisible)
+{
+    pool.setMaxThreadCount(workers);
+    for (int i=0; i<=PriorityBackground; i++)
+    {
+        latency[i].count = 0;
+        latency[i].total = latency[i].max = 0;
+    }
 }
 
 LoaderThreadBase::~LoaderThreadBase()
@@ -33,43 +56,74 @@ void LoaderThreadBase::setPriority(QThread::Priority p)
 
 void LoaderThreadBase::setSink(QSharedPointer<ImgSink> sink)
 {
-    sinkMutex.lock();
+    loaderMutex.lock();
     this->sink = sink;
-    sinkMutex.unlock();
+    ++generation;
+    requests.clear();
+    foreach (CancellationToken t, running)
+    {
+        t.cancel();
+    }
+    loaderMutex.unlock();
 }
 
-void LoaderThreadBase::request(int page)
+void LoaderThreadBase::setWorkers(int n)
 {
-    _DEBUG << "requested page" << page;
-
+    n = qMax(n, 1);
     loaderMutex.lock();
-    const LoadRequest req(page, false);
-    if (requests.contains(req))
-    {
-        _DEBUG << "requests queue already has" << page;
-        loaderMutex.unlock();
-        return;
-    }
-    requests.append(req);
+    workers = n;
     loaderMutex.unlock();
-    reqCond.wakeOne();
+    pool.setMaxThreadCount(n);
 }
 
-void LoaderThreadBase::requestTwoPages(int page)
+void LoaderThreadBase::schedule(LoadRequest &req)
+{
+    req.deadline = req.queued + LoadRequest::budget(req.priority);
+}
+
+LoadRequest LoaderThreadBase::takeRequest()
 {
-    _DEBUG << "requested 2 pages" << page;
+    return requests.pop();
+}
 
+void LoaderThreadBase::enqueue(LoadRequest req)
+{
     loaderMutex.lock();
-    const LoadRequest req(page, true);
-    if (requests.contains(req))
+    req.generation = generation;
+    schedule(req);
+    if (!requests.push(req))
     {
-        _DEBUG << "requests queue (2 pages) already has" << page;
+        _DEBUG << "requests queue already has" << req.pageNumber << "two pages:" << req.twoPages;
         loaderMutex.unlock();
         return;
     }
-    requests.append(req);
-    loaderMutex.unlock();
+    //
+    // woken while loaderMutex is held, so the thread is either waiting or will see the request
+    // before it waits again; no wakeup is lost
     reqCond.wakeOne();
+    loaderMutex.unlock();
+}
+
+void LoaderThreadBase::request(int page)
+{
+    requestPage(page, defaultPriority);
+}
+
+void LoaderThreadBase::requestTwoPages(int page)
+{
+    requestTwoPages(page, defaultPriority);
+}
+
+void LoaderThreadBase::requestPage(int page, int priority)
+{
+    _DEBUG << "requested page" << page << "priority" << priority;
+    enqueue(LoadRequest(page, false, priority));
+}
+
+void LoaderThreadBase::requestTwoPages(int page, int priority)
+{
+    _DEBUG << "requested 2 pages" << page << "priority" << priority;
+    enqueue(LoadRequest(page, true, priority));
 }
 
 void LoaderThreadBase::request(int first, int n)
@@ -83,9 +137,14 @@ void LoaderThreadBase::request(int first, int n)
 void LoaderThreadBase::cancel(int page)
 {
     loaderMutex.lock();
-    const LoadRequest req(page, false);
     _DEBUG << "page" << page;
-    requests.removeAll(req);
+    if (!requests.remove(page, false))
+    {
+        foreach (CancellationToken t, running.values(LoadRequest::id(page, false)))
+        {
+            t.cancel();
+        }
+    }
     loaderMutex.unlock();
 }
 
@@ -93,8 +152,13 @@ void LoaderThreadBase::cancelTwoPages(int page)
 {
     loaderMutex.lock();
     _DEBUG << "2 pages" << page;
-    const LoadRequest req(page, true);
-    requests.removeAll(req);
+    if (!requests.remove(page, true))
+    {
+        foreach (CancellationToken t, running.values(LoadRequest::id(page, true)))
+        {
+            t.cancel();
+        }
+    }
     loaderMutex.unlock();
 }
 
@@ -103,6 +167,23 @@ void LoaderThreadBase::cancelAll()
     loaderMutex.lock();
     _DEBUG << "all pages";
     requests.clear();
+    foreach (CancellationToken t, running)
+    {
+        t.cancel();
+    }
+    loaderMutex.unlock();
+}
+
+void LoaderThreadBase::startRequest(const LoadRequest &req)
+{
+    running.insert(req.id(), req.token);
+    addLatency(req);
+}
+
+void LoaderThreadBase::finishRequest(const LoadRequest &req)
+{
+    loaderMutex.lock();
+    running.remove(req.id(), req.token);
     loaderMutex.unlock();
 }
 
@@ -110,43 +191,118 @@ void LoaderThreadBase::stop()
 {
     loaderMutex.lock();
     stopped = true;
-    loaderMutex.unlock();
     reqCond.wakeOne();
+    loaderMutex.unlock();
+}
+
+void LoaderThreadBase::addLatency(const LoadRequest &req)
+{
+    const int p = qBound(0, req.priority, static_cast<int>(PriorityBackground));
+    const qint64 wait = LoadRequest::now() - req.queued;
+    LatencyStats &stats(latency[p]);
+    ++stats.count;
+    stats.total += wait;
+    stats.max = qMax(stats.max, wait);
+    if (req.deadline < LoadRequest::now())
+    {
+        _DEBUG << "page" << req.pageNumber << "missed deadline by" << (LoadRequest::now() - req.deadline) << "ms";
+    }
+}
+
+int LoaderThreadBase::concurrency() const
+{
+    return sink ? qMin(static_cast<int>(workers), sink->maxConcurrency()) : 1;
 }
 
 void LoaderThreadBase::run()
 {
+    bool idle = true; // queueEmpty() was called since last request was taken
+    loaderMutex.lock();
     for (;;)
     {
-        condMutex.lock();
-        reqCond.wait(&condMutex);
-        condMutex.unlock();
-        	
-        for (;;) {
-            loaderMutex.lock();
-            if (stopped)
-            {
-                loaderMutex.unlock();
-                return;
-            }
-
-            if (requests.empty())
+        //
+        // wait for a request and a free worker; both new requests and finished workers wake
+        // the thread, so a request arriving while workers are busy takes the first free one
+        // and requests queued meanwhile still compete for it
+        int limit = concurrency();
+        while (!stopped && (requests.isEmpty() || active >= limit))
+        {
+            if (!idle && requests.isEmpty() && active == 0)
             {
+                idle = true;
+                for (int i=0; i<=PriorityBackground; i++)
+                {
+                    if (latency[i].count > 0)
+                    {
+                        _DEBUG << "priority" << i << "requests:" << latency[i].count << "avg wait:" << latency[i].total / latency[i].count << "ms max wait:" << latency[i].max << "ms";
+                    }
+                }
+                const QSharedPointer<ImgSink> s(sink);
                 loaderMutex.unlock();
-                break;
+                if (s)
+                {
+                    queueEmpty(s);
+                }
+                loaderMutex.lock();
+                continue; // requests may have arrived meanwhile
             }
-            const LoadRequest req(requests.first());
-            requests.pop_front();
+            reqCond.wait(&loaderMutex);
+            limit = concurrency();
+        }
+        if (stopped)
+        {
             loaderMutex.unlock();
+            waitForWorkers();
+            return;
+        }
 
-            sinkMutex.lock(); //TODO is it safe to lock when process() may emit signal?
-            if (sink)
-            {
-                _DEBUG << "loading" << req.pageNumber;
-                process(req);
-            }
-            sinkMutex.unlock();
-	}
+        //
+        // request and sink are taken together, so request is never processed with sink it wasn't made for
+        const LoadRequest req(takeRequest());
+        const QSharedPointer<ImgSink> s(sink);
+        if (!s || req.generation != generation)
+        {
+            continue;
+        }
+        idle = false;
+        startRequest(req);
+        if (limit > 1)
+        {
+            ++active;
+            loaderMutex.unlock();
+            _DEBUG << "dispatching" << req.pageNumber;
+            pool.start(new LoaderTask(this, req, s));
+        }
+        else
+        {
+            loaderMutex.unlock();
+            _DEBUG << "loading" << req.pageNumber;
+            process(req, s);
+            finishRequest(req);
+        }
+        loaderMutex.lock();
     }
 }
 
+void LoaderThreadBase::runTask(const LoadRequest &req, const QSharedPointer<ImgSink> &sink)
+{
+    _DEBUG << "loading" << req.pageNumber;
+    process(req, sink);
+
+    loaderMutex.lock();
+    running.remove(req.id(), req.token);
+    --active;
+    loaderMutex.unlock();
+    workerDone.wakeAll();
+    reqCond.wakeOne(); // free worker for next request
+}
+
+void LoaderThreadBase::waitForWorkers()
+{
+    loaderMutex.lock();
+    while (active > 0)
+    {
+        workerDone.wait(&loaderMutex);
+    }
+    loaderMutex.unlock();
+}
@@ -18,58 +18,111 @@
 #include <QMutex>
 #include <QWaitCondition>
 #include <QSharedPointer>
+#include <QThreadPool>
+#include <QMultiHash>
 #include "Sink/ImgSink.h"
+#include "LoadRequest.h"
 
 namespace QComicBook
 {
     class Page;
     
-    struct LoadRequest
-    {
-        int pageNumber;
-        bool twoPages;
-        
-        LoadRequest(int page, bool twoPages): pageNumber(page), twoPages(twoPages) {}
-        bool operator==(const LoadRequest &r)
-        {
-            return pageNumber == r.pageNumber && twoPages == r.twoPages;
-        }
-    };
-    
     class LoaderThreadBase: public QThread
     {
             Q_OBJECT
 
             protected:
                 volatile QThread::Priority prio; //!<thread priority
-                QList<LoadRequest> requests; //!<the list of requested pages
-                QSharedPointer<ImgSink> sink;
+                LoadRequestQueue requests; //!<requested pages, most urgent first; guarded by loaderMutex
+                QMultiHash<int, CancellationToken> running; //!< tokens of requests being processed by LoadRequest::id(); guarded by loaderMutex
+                QSharedPointer<ImgSink> sink; //!< guarded by loaderMutex
+                int generation; //!< incremented whenever sink changes; guarded by loaderMutex
                 QMutex loaderMutex;
-                QMutex condMutex;
-                QMutex sinkMutex;
-                QWaitCondition reqCond;
+                QWaitCondition reqCond; //!< signalled when a request is queued, a worker finishes or thread is stopped; used with loaderMutex
+                QWaitCondition workerDone; //!< signalled when a worker finishes; used by waitForWorkers()
                 volatile bool stopped;
+                volatile int workers; //!< max number of requests processed in parallel
+                int active; //!< number of requests being processed by workers; guarded by loaderMutex
+                QThreadPool pool;
 
                 //! Main function of the thread.
-                /*! Preloads requested pages from requests list using sink->getImage().
+                /*! Preloads requested pages from requests queue using sink->getImage(),
+                 *  most urgent first (see LoadRequestQueue). Requests are dispatched to the workers pool if both the number of workers
+                 *  and ImgSink::maxConcurrency() are greater than 1; otherwise they are
+                 *  processed by this thread. Requests made for previous sink are dropped.
                  *  Stop if stopped flag is true.
                  *  @see ImgDirSink::getImage
                  */
                 virtual void run();
 
-                virtual bool process(const LoadRequest &req) = 0;
+                //! Processes single request.
+                /*! May be called from several workers at once, see setWorkers(). Long operations
+                 *  should give up early once req.token is cancelled (see cancel()).
+                 *  @param req request; req.generation tells results of replaced sink from current ones
+                 *  @param sink sink request was made for; may be already replaced by setSink() */
+                virtual bool process(const LoadRequest &req, const QSharedPointer<ImgSink> &sink) = 0;
+
+                //! Sets priority and deadline of new request before it's queued.
+                /*! Called with loaderMutex locked. Default deadline is given by LoadRequest::budget(). */
+                virtual void schedule(LoadRequest &req);
+
+                //! Removes and returns request to process next.
+                /*! Called with loaderMutex locked and requests not empty. Default is the most urgent one. */
+                virtual LoadRequest takeRequest();
+
+                //! Called when all pending requests have been processed.
+                virtual void queueEmpty(const QSharedPointer<ImgSink> &sink) {}
+
+                //! Queues request; wakes the thread if it wasn't queued yet.
+                void enqueue(LoadRequest req);
+
+                //! Waits until all dispatched requests are processed; used when thread is stopped.
+                void waitForWorkers();
+
+                //! Number of requests that may be processed at once. Called with loaderMutex locked.
+                int concurrency() const;
+
+                //! Marks request as being processed, so that cancel() can abort it.
+                /*! startRequest() is called with loaderMutex locked, finishRequest() without. */
+                void startRequest(const LoadRequest &req);
+                void finishRequest(const LoadRequest &req);
+
+                //! Records how long request waited in queue before its processing started.
+                /*! Called with loaderMutex locked. */
+                void addLatency(const LoadRequest &req);
+
+                //! Default priority of requests that don't specify it.
+                int defaultPriority;
+
+            private:
+                struct LatencyStats
+                {
+                    int count;
+                    qint64 total;
+                    qint64 max;
+                };
+                LatencyStats latency[PriorityBackground + 1]; //!< per-priority queue wait times; guarded by loaderMutex
 
            public:
                 LoaderThreadBase();
                 virtual ~LoaderThreadBase();
 
+                //! Sets number of workers processing requests in parallel.
+                /*! @param n number of workers; 1 means all requests are processed by this thread */
+                void setWorkers(int n);
+
+                //! Processes request on a worker thread; used by workers pool.
+                void runTask(const LoadRequest &req, const QSharedPointer<ImgSink> &sink);
+
                 //! Changes priority of the loader thread.
                 /*! @param p new priority
                  */
                 virtual void setPriority(QThread::Priority p);
 
                 //! Sets image source sink.
-                /*! @param sink image sink used for retrieving (loading) images
+                /*! Doesn't wait for requests of previous sink: they are dropped from the queue,
+                 *  cancelled if running, and their results are discarded (see generation).
+                 *  @param sink image sink used for retrieving (loading) images
                  */
                 virtual void setSink(QSharedPointer<ImgSink> sink = QSharedPointer<ImgSink>());
                 
@@ -78,12 +131,21 @@ namespace QComicBook
                 
                 
            public slots:
-                //! Appends page to the list of pages to load.
+                //! Queues page for loading with default priority.
                 /*! @param page page to load
                  */
                 virtual void request(int page);
                 
                 virtual void requestTwoPages(int page);
+
+                //! Queues page for loading.
+                /*! If the page is already queued, its request is only made more urgent, never less.
+                 *  @param page page to load
+                 *  @param priority one of LoadPriority
+                 */
+                virtual void requestPage(int page, int priority);
+
+                virtual void requestTwoPages(int page, int priority);
                 
                 //! Appends few pages to the list of pages to load.
                 /*! @param first starting page
@@ -91,6 +153,8 @@ namespace QComicBook
                  */
                 virtual void request(int first, int n);
                 
+                //! Cancels request of given page.
+                /*! Queued request is dropped; request that is being processed gets its token cancelled. */
                 virtual void cancel(int page);
                 virtual void cancelTwoPages(int page);
                 virtual void cancelAll();
@@ -13,30 +13,85 @@
 #include "PageLoaderThread.h"
 #include "Page.h"
 #include "Sink/ImgDirSink.h"
+#include "PrefetchPolicy.h"
+#include "ComicBookDebug.h"
+#include <QElapsedTimer>
 
 using namespace QComicBook;
 
+const int PageLoaderThread::MAX_WORKERS = 4;
+
 PageLoaderThread::PageLoaderThread(): LoaderThreadBase()
 {
+    setWorkers(qBound(1, QThread::idealThreadCount(), MAX_WORKERS));
 }
 
 PageLoaderThread::~PageLoaderThread()
 {
 }
 
-bool PageLoaderThread::process(const LoadRequest &req)
+bool PageLoaderThread::process(const LoadRequest &req, const QSharedPointer<ImgSink> &sink)
 {
     int result;
+    QElapsedTimer timer;
+    timer.start();
     if (req.twoPages)
     {                
-        const Page page1(sink->getImage(req.pageNumber, result));
-        const Page page2(sink->getImage(req.pageNumber+1, result));
-        emit pageLoaded(page1, page2); //TODO errors
+        //
+        // second page is decoded in background while this worker decodes the first one;
+        // if nobody picks it up, result() below decodes it here
+        PageFuture second(sink->requestPage(req.pageNumber+1, req.token));
+        if (sink->maxConcurrency() > 1)
+        {
+            second.start();
+        }
+        const Page page1(sink->getImage(req.pageNumber, result, req.token));
+        int result2;
+        const Page page2(second.result(&result2));
+        if (result == SINKERR_CANCELLED || result2 == SINKERR_CANCELLED)
+        {
+            _DEBUG << "cancelled 2 pages" << req.pageNumber;
+            return false;
+        }
+        QMetaObject::invokeMethod(this, "deliverTwoPages", Qt::QueuedConnection, Q_ARG(Page, page1), Q_ARG(Page, page2), Q_ARG(int, req.generation), Q_ARG(int, timer.elapsed())); //TODO errors
     }
     else
     {
-        const Page page(sink->getImage(req.pageNumber, result));
-        emit pageLoaded(page);
+        const Page page(sink->getImage(req.pageNumber, result, req.token));
+        if (result == SINKERR_CANCELLED)
+        {
+            _DEBUG << "cancelled page" << req.pageNumber;
+            return false;
+        }
+        QMetaObject::invokeMethod(this, "deliverPage", Qt::QueuedConnection, Q_ARG(Page, page), Q_ARG(int, req.generation), Q_ARG(int, timer.elapsed()));
     }
     return true;
 }
+
+void PageLoaderThread::deliverPage(const Page &p, int generation, int ms)
+{
+    loaderMutex.lock();
+    const bool stale = generation != this->generation;
+    loaderMutex.unlock();
+    if (stale)
+    {
+        _DEBUG << "discarding page of previous sink" << p.getNumber();
+        return;
+    }
+    PrefetchPolicy::instance().pageDecoded(p.getNumber(), 1, ms, p.getImage().byteCount());
+    emit pageLoaded(p);
+}
+
+void PageLoaderThread::deliverTwoPages(const Page &p1, const Page &p2, int generation, int ms)
+{
+    loaderMutex.lock();
+    const bool stale = generation != this->generation;
+    loaderMutex.unlock();
+    if (stale)
+    {
+        _DEBUG << "discarding pages of previous sink" << p1.getNumber();
+        return;
+    }
+    PrefetchPolicy::instance().pageDecoded(p1.getNumber(), 2, ms, p1.getImage().byteCount() + p2.getImage().byteCount());
+    emit pageLoaded(p1, p2);
+}
@@ -22,6 +22,11 @@ namespace QComicBook
     class Page;
 
     //! Thread-based image loader.
+    /*! Pages are decoded by a bounded pool of workers if the sink allows it (see
+     *  ImgSink::maxConcurrency()). Each request is delivered by a single pageLoaded
+     *  signal once all of its pages are decoded, so both pages of a spread always
+     *  arrive together. Signals are emited in the thread of this object, and only
+     *  for pages of current sink; results of replaced sink are discarded. */
     class PageLoaderThread: public LoaderThreadBase
     {
         Q_OBJECT
@@ -35,7 +40,16 @@ namespace QComicBook
             virtual ~PageLoaderThread();
         
         protected:
-            virtual bool process(const LoadRequest &req);
+            virtual bool process(const LoadRequest &req, const QSharedPointer<ImgSink> &sink);
+
+        private slots:
+            //! Emits pageLoaded if page was loaded for current sink.
+            /*! @param ms time it took to load the page */
+            void deliverPage(const Page &p, int generation, int ms);
+            void deliverTwoPages(const Page &p1, const Page &p2, int generation, int ms);
+
+        private:
+            static const int MAX_WORKERS; //!< upper bound of decoding workers; pages are large, so more would only cost memory
         
     };
 }
@@ -0,0 +1,169 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2010 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+#include "PrefetchPolicy.h"
+#include "ComicBookSettings.h"
+#include "ComicBookDebug.h"
+#include <QtGlobal>
+
+using namespace QComicBook;
+
+const int PrefetchPolicy::MAX_AHEAD = 8;
+const int PrefetchPolicy::MAX_PAUSE = 30000;
+const double PrefetchPolicy::SMOOTHING = 0.3;
+
+PrefetchPolicy& PrefetchPolicy::instance()
+{
+    static PrefetchPolicy policy;
+    return policy;
+}
+
+PrefetchPolicy::PrefetchPolicy()
+{
+    reset();
+}
+
+void PrefetchPolicy::reset()
+{
+    m_lastPage = -1;
+    m_msPerPage = 10000.0; // slow reader, so that prefetching starts at one page
+    m_decodeMs = 200.0;
+    m_stepBytes = 0.0;
+    m_direction = 1.0;
+    m_ready.clear();
+    m_hits = m_misses = m_jumps = 0;
+    m_timer.invalidate();
+}
+
+void PrefetchPolicy::pageShown(int page)
+{
+    if (page == m_lastPage)
+    {
+        return;
+    }
+    const int step = page - m_lastPage;
+    if (m_lastPage < 0 || qAbs(step) > 2)
+    {
+        //
+        // opened or jumped; nothing could have been prefetched for it and time spent
+        // on previous page says nothing about reading speed
+        if (m_lastPage >= 0)
+            ++m_jumps;
+    }
+    else
+    {
+        if (m_ready.contains(page))
+            ++m_hits;
+        else
+            ++m_misses;
+
+        if (m_timer.isValid())
+        {
+            const qint64 ms = qMin(m_timer.elapsed(), static_cast<qint64>(MAX_PAUSE));
+            m_msPerPage += SMOOTHING * (ms - m_msPerPage);
+        }
+        m_direction += SMOOTHING * ((step > 0 ? 1.0 : -1.0) - m_direction);
+    }
+    m_lastPage = page;
+    m_timer.start();
+
+    //
+    // pages far from current one have likely been dropped from the cache
+    const int keep = 2 * (MAX_AHEAD + 1) * 2;
+    QSet<int>::iterator it = m_ready.begin();
+    while (it != m_ready.end())
+    {
+        if (qAbs(*it - page) > keep)
+            it = m_ready.erase(it);
+        else
+            ++it;
+    }
+    _DEBUG << "page" << page << "ms/page" << msPerPage() << "direction" << m_direction << "hits" << m_hits << "misses" << m_misses;
+}
+
+void PrefetchPolicy::pageDecoded(int page, int pages, int ms, qint64 bytes)
+{
+    for (int i=0; i<pages; i++)
+    {
+        m_ready.insert(page + i);
+    }
+    if (ms > 0) // pages from cache say nothing about decoding cost
+    {
+        m_decodeMs += SMOOTHING * (ms - m_decodeMs);
+    }
+    if (m_stepBytes <= 0.0)
+        m_stepBytes = bytes;
+    else
+        m_stepBytes += SMOOTHING * (bytes - m_stepBytes);
+}
+
+void PrefetchPolicy::window(int &ahead, int &behind) const
+{
+    //
+    // keep enough steps ready to hide decoding behind reading: one step, plus one more
+    // for every half of page time a step takes to decode
+    int n = 1 + static_cast<int>(2.0 * m_decodeMs / qMax(m_msPerPage, 1.0));
+    n = qBound(1, n, MAX_AHEAD);
+
+    int forward, backward;
+    if (qAbs(m_direction) < 0.5)
+    {
+        // no clear direction: split between both sides
+        forward = backward = qMax(1, (n + 1) / 2);
+    }
+    else
+    {
+        forward = n;
+        backward = 0;
+    }
+    if (m_direction <= -0.5)
+    {
+        qSwap(forward, backward);
+    }
+
+    //
+    // preloaded pages wait in pages cache with the current one; don't preload more than fits
+    if (m_stepBytes > 0.0)
+    {
+        const double budget = static_cast<double>(ComicBookSettings::instance().cacheSize()) * 1024 * 1024;
+        const int fits = qMax(0, static_cast<int>(budget / m_stepBytes) - 1);
+        while (forward + backward > fits)
+        {
+            if (forward > backward)
+                --forward;
+            else
+                --backward;
+        }
+    }
+    ahead = forward;
+    behind = backward;
+}
+
+int PrefetchPolicy::pagesAhead() const
+{
+    int ahead, behind;
+    window(ahead, behind);
+    return ahead;
+}
+
+int PrefetchPolicy::pagesBehind() const
+{
+    int ahead, behind;
+    window(ahead, behind);
+    return behind;
+}
+
+double PrefetchPolicy::hitRate() const
+{
+    const int turns = m_hits + m_misses;
+    return turns > 0 ? 100.0 * m_hits / turns : 0.0;
+}
@@ -0,0 +1,84 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2010 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+/*! \file PrefetchPolicy.h */
+
+#ifndef __PREFETCHPOLICY_H
+#define __PREFETCHPOLICY_H
+
+#include <QSet>
+#include <QElapsedTimer>
+
+namespace QComicBook
+{
+    //! Decides how many pages to preload around the current one.
+    /*! Learns how long the reader stays on a page, which way they read and how long
+     *  pages take to decode, and keeps enough pages ready so that decoding keeps up
+     *  with reading, within the limit of pages cache. Direction is learned in page
+     *  order, so it works the same for manga mode. All numbers of pages are in view
+     *  steps (a spread in two pages mode). Used from GUI thread only.
+     */
+    class PrefetchPolicy
+    {
+        public:
+            static PrefetchPolicy& instance();
+
+            //! Forgets everything learned; called when comic book changes.
+            void reset();
+
+            //! Records that page is shown to the reader.
+            void pageShown(int page);
+
+            //! Records that page was loaded and is ready to be shown.
+            /*! @param page first page of a view step
+             *  @param pages number of pages loaded (2 for a spread)
+             *  @param ms time it took to load the page(s); 0 if it's unknown
+             *  @param bytes memory used by page(s) */
+            void pageDecoded(int page, int pages, int ms, qint64 bytes);
+
+            //! @return number of steps to preload after current page
+            int pagesAhead() const;
+            //! @return number of steps to preload before current page
+            int pagesBehind() const;
+
+            int hits() const { return m_hits; }
+            int misses() const { return m_misses; }
+            int jumps() const { return m_jumps; }
+            //! @return percentage of page turns that found next page ready
+            double hitRate() const;
+            int msPerPage() const { return static_cast<int>(m_msPerPage); }
+            int decodeMs() const { return static_cast<int>(m_decodeMs); }
+            //! @return 1 for reading forward, -1 for backward
+            double direction() const { return m_direction; }
+
+        private:
+            PrefetchPolicy();
+            void window(int &ahead, int &behind) const;
+
+            static const int MAX_AHEAD; //!< maximum number of steps preloaded in reading direction
+            static const int MAX_PAUSE; //!< longer stays on a page (ms) are treated as breaks in reading
+            static const double SMOOTHING; //!< weight of new sample in running averages
+
+            QElapsedTimer m_timer; //!< time since last page turn
+            int m_lastPage;
+            double m_msPerPage; //!< average time reader stays on a page
+            double m_decodeMs; //!< average time a step takes to load
+            double m_stepBytes; //!< average memory of a loaded step
+            double m_direction; //!< average direction of page turns, from -1 to 1
+            QSet<int> m_ready; //!< pages loaded near current page
+            int m_hits;
+            int m_misses;
+            int m_jumps; //!< page changes that aren't page turns (e.g. go to page)
+    };
+}
+
+#endif
@@ -0,0 +1,59 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2010 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+#include "CancellableDevice.h"
+
+using namespace QComicBook;
+
+CancellableDevice::CancellableDevice(QIODevice *dev, const CancellationToken &token)
+	: QIODevice()
+	, dev(dev)
+	, token(token)
+{
+	//
+	// unbuffered, so that reads reach readData() and the token is checked for every chunk
+	open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+bool CancellableDevice::isSequential() const
+{
+	return dev->isSequential();
+}
+
+bool CancellableDevice::seek(qint64 pos)
+{
+	return QIODevice::seek(pos) && dev->seek(pos);
+}
+
+qint64 CancellableDevice::pos() const
+{
+	return dev->pos();
+}
+
+qint64 CancellableDevice::size() const
+{
+	return dev->size();
+}
+
+qint64 CancellableDevice::readData(char *data, qint64 maxSize)
+{
+	if (token.isCancelled())
+	{
+		return -1;
+	}
+	return dev->read(data, maxSize);
+}
+
+qint64 CancellableDevice::writeData(const char *, qint64)
+{
+	return -1;
+}
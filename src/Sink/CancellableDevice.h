@@ -0,0 +1,47 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2010 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+#ifndef __CANCELLABLEDEVICE_H
+#define __CANCELLABLEDEVICE_H
+
+#include <QIODevice>
+#include "CancellationToken.h"
+
+namespace QComicBook
+{
+	//! Read-only wrapper of a device that fails reads once its token is cancelled.
+	/*! Image readers pull data in chunks while decoding, so a decode reading through
+	 *  this device stops with an error shortly after cancellation instead of
+	 *  running to the end.
+	 */
+	class CancellableDevice: public QIODevice
+	{
+		public:
+			//! @param dev opened device to read from; not owned
+			CancellableDevice(QIODevice *dev, const CancellationToken &token);
+
+			virtual bool isSequential() const;
+			virtual bool seek(qint64 pos);
+			virtual qint64 pos() const;
+			virtual qint64 size() const;
+
+		protected:
+			virtual qint64 readData(char *data, qint64 maxSize);
+			virtual qint64 writeData(const char *data, qint64 maxSize);
+
+		private:
+			QIODevice *dev;
+			const CancellationToken token;
+	};
+}
+
+#endif
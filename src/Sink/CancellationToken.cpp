@@ -0,0 +1,53 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2010 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+#include "CancellationToken.h"
+#include <QMutexLocker>
+
+using namespace QComicBook;
+
+CancellationToken::CancellationToken()
+	: d(new Data)
+{
+}
+
+void CancellationToken::cancel()
+{
+	d->cancelled.fetchAndStoreOrdered(1);
+}
+
+bool CancellationToken::isCancelled() const
+{
+	if (d->cancelled.loadAcquire())
+	{
+		return true;
+	}
+	QMutexLocker lock(&d->mtx);
+	if (d->sources.isEmpty())
+	{
+		return false;
+	}
+	foreach (const CancellationToken &t, d->sources)
+	{
+		if (!t.isCancelled())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void CancellationToken::addSource(const CancellationToken &t)
+{
+	QMutexLocker lock(&d->mtx);
+	d->sources.append(t);
+}
@@ -0,0 +1,54 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2010 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+#ifndef __CANCELLATIONTOKEN_H
+#define __CANCELLATIONTOKEN_H
+
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QList>
+
+namespace QComicBook
+{
+	//! Flag shared by a long operation and parties that may want to abort it.
+	/*! Copies of a token share the same flag. A token may also be linked to
+	 *  source tokens with addSource(); it then counts as cancelled once all of
+	 *  its sources are cancelled, which is how a decode shared by several consumers
+	 *  is dropped only when nobody wants it anymore. Thread-safe.
+	 */
+	class CancellationToken
+	{
+		public:
+			//! Creates new, not cancelled token.
+			CancellationToken();
+
+			void cancel();
+			bool isCancelled() const;
+
+			//! Makes this token cancelled when all its sources are cancelled.
+			void addSource(const CancellationToken &t);
+
+			bool operator==(const CancellationToken &t) const { return d == t.d; }
+
+		private:
+			struct Data
+			{
+				QAtomicInt cancelled;
+				QMutex mtx;
+				QList<CancellationToken> sources;
+			};
+			QSharedPointer<Data> d;
+	};
+}
+
+#endif
@@ -14,6 +14,7 @@
 #include "Utility.h"
 #include "Archivers/ArchiversConfiguration.h"
 #include "ComicBookSettings.h"
+#include "ContentHash.h"
 #include <QStringList>
 #include <QProcess>
 #include <QTextStream>
@@ -173,6 +174,12 @@ int ImgArchiveSink::open(const QString &path) //TODO: cleanup if already opened?
 	{
 		if (info.isReadable())
 		{
+			//
+			// identity of the archive file itself; extracted files get new timestamps
+			ContentHash h;
+			h.addFile(path);
+			setContentKey(h.result());
+
                         tmppath = makeTempDir(ComicBookSettings::instance().tmpDir());
 			archdirs.prepend(tmppath);
                         QStringList extractargs, listargs;
@@ -11,9 +11,11 @@
  */
 
 #include "ImgDirSink.h"
-#include "ComicBookSettings.h"
 #include "ImageFormatsInfo.h"
+#include "ContentHash.h"
+#include "CancellableDevice.h"
 #include <QImage>
+#include <QImageReader>
 #include <QStringList>
 #include <QDir>
 #include <QFile>
@@ -112,7 +114,10 @@ int ImgDirSink::open(const QString &path)
         }
         setComicBookName(path, dirpath);
         if (status == 0)
+        {
+                setContentKey(makeContentKey());
                 emit progress(1, 1);
+        }
         return status;
 }
 
@@ -127,6 +132,29 @@ void ImgDirSink::close()
         listmtx.unlock();
 }
 
+QByteArray ImgDirSink::makeContentKey() const
+{
+	//
+	// names, sizes and modification times of all pages plus sampled contents of
+	// first and last page; path of the directory is not used, so moved directory keeps its key
+	ContentHash h;
+	listmtx.lock();
+	foreach (const QString &f, imgfiles)
+	{
+		const QFileInfo finfo(f);
+		h.add(finfo.fileName().toUtf8());
+		h.add(finfo.size());
+		h.add(finfo.lastModified().toMSecsSinceEpoch());
+	}
+	if (!imgfiles.isEmpty())
+	{
+		h.addFile(imgfiles.first());
+		h.addFile(imgfiles.last());
+	}
+	listmtx.unlock();
+	return h.result();
+}
+
 QString ImgDirSink::getFullFileName(int page) const
 {
 	return page < numOfImages() ? imgfiles[page] : QString::null;
@@ -156,6 +184,11 @@ QStringList ImgDirSink::getDescription() const
 }
 
 QImage ImgDirSink::image(unsigned int num, int &result)
+{
+	return image(num, result, CancellationToken());
+}
+
+QImage ImgDirSink::image(unsigned int num, int &result, const CancellationToken &token)
 {
 	result = SINKERR_LOADERROR;
 
@@ -168,10 +201,27 @@ QImage ImgDirSink::image(unsigned int num, int &result)
 		const QString fname = imgfiles[num];
 		listmtx.unlock();
 
-		if (!im.load(fname))
-			result = 1;
+		//
+		// image is read incrementally through a device that fails once token is cancelled,
+		// so decoding of a page nobody waits for stops after the current chunk
+		QFile f(fname);
+		if (f.open(QIODevice::ReadOnly))
+		{
+			CancellableDevice dev(&f, token);
+			QImageReader reader(&dev);
+			//
+			// wrapped device has no file name to guess format from; suffix is only a hint,
+			// reader still detects format from content if it doesn't match
+			reader.setFormat(QFileInfo(fname).suffix().toLatin1());
+			if (reader.read(&im))
+				result = 0;
+			else if (token.isCancelled())
+				result = SINKERR_CANCELLED;
+			else
+				result = 1;
+		}
 		else
-			result = 0;
+			result = 1;
 
 		/*const QFileInfo finf(fname);
 
@@ -193,6 +243,47 @@ QImage ImgDirSink::image(unsigned int num, int &result)
 	return page;
 }
 
+QImage ImgDirSink::thumbnailImage(unsigned int num, const QSize &size, int &result)
+{
+	result = SINKERR_LOADERROR;
+
+	listmtx.lock();
+	if (num >= imgfiles.count())
+	{
+		listmtx.unlock();
+		return QImage();
+	}
+	const QString fname = imgfiles[num];
+	listmtx.unlock();
+
+	QImageReader reader(fname);
+	const QSize fullSize(reader.size());
+	if (fullSize.isValid() && reader.supportsOption(QImageIOHandler::ScaledSize))
+	{
+		//
+		// JPEG reader decodes 1/2, 1/4 and 1/8 scaled images directly (DCT scaling);
+		// pick the largest power of 2 divisor that keeps the image at least thumbnail size
+		const double scale = qMin(static_cast<double>(size.width()) / fullSize.width(),
+					  static_cast<double>(size.height()) / fullSize.height());
+		int denom = 1;
+		while (denom < 8 && scale * denom * 2 <= 1.0)
+		{
+			denom *= 2;
+		}
+		if (denom > 1)
+		{
+			reader.setScaledSize(QSize((fullSize.width() + denom - 1) / denom, (fullSize.height() + denom - 1) / denom));
+		}
+	}
+
+	QImage im;
+	if (reader.read(&im))
+	{
+		result = 0;
+	}
+	return im;
+}
+
 int ImgDirSink::numOfImages() const
 {
         listmtx.lock();
@@ -261,23 +352,6 @@ QString ImgDirSink::getPrevious() const
 	return QString::null;
 }
 
-void ImgDirSink::removeThumbnails(int days)
-{       
-        if (days < 1)
-                return;
-
-        const QDateTime currdate = QDateTime::currentDateTime();
-        
-        QDir dir(ComicBookSettings::instance().thumbnailsDir(), "*.jpg", QDir::Unsorted, QDir::Files|QDir::NoSymLinks);
-        const QStringList files = dir.entryList();
-        for (QStringList::const_iterator it = files.begin(); it!=files.end(); it++)
-        {
-                QFileInfo finfo(dir.absoluteFilePath(*it));
-                if (finfo.lastModified().daysTo(currdate) > days)
-                        dir.remove(*it);
-        }
-}
-
 bool ImgDirSink::knownImageExtension(const QString &path)
 {
     foreach (QString ext, ImageFormatsInfo::instance().extensions())
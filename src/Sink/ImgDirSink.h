@@ -20,6 +20,7 @@
 #include <QDateTime>
 #include <QMap>
 #include <QMutex>
+#include <climits>
 #include "DirReader.h"
 #include "ImgSink.h"
 #include "../Page.h"
@@ -58,6 +59,9 @@ namespace QComicBook
 			static const int MAX_TEXTFILE_SIZE;
 		
 			virtual bool fileHandler(const QFileInfo &finfo);
+
+			//! Builds content identity of the comic book from its image files.
+			QByteArray makeContentKey() const;
 		
 		private:
 			mutable QMutex listmtx; //!< mutex for imgfiles
@@ -90,9 +94,16 @@ namespace QComicBook
 			 *  @param result contains 0 on succes or value greater than 0 for error
 			 *  @return an image */
 			virtual QImage image(unsigned int num, int &result);
+			virtual QImage image(unsigned int num, int &result, const CancellationToken &token);
+
+			//! Returns page decoded at the smallest of 1/2, 1/4 or 1/8 scale that still covers thumbnail size.
+			virtual QImage thumbnailImage(unsigned int num, const QSize &size, int &result);
 
 			/*! @return number of images for this comic book sink */
 			virtual int numOfImages() const;
+
+			//! Image files are independent, so any number of pages may be loaded at once.
+			virtual int maxConcurrency() const { return INT_MAX; }
 			
 			virtual QString getFullFileName(int page) const;
 
@@ -114,9 +125,6 @@ namespace QComicBook
 			virtual QString getPrevious() const;
 
 			//
-			//! Removes old thumbnails.
-			/*! @param days thumbnails older than this number will be removed */
-			static void removeThumbnails(int days);
 
 			static bool knownImageExtension(const QString &path);
 			static QString getKnownImageExtension(const QString &path);
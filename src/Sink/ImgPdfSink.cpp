@@ -12,6 +12,7 @@
 
 #include "ImgPdfSink.h"
 #include "../Page.h"
+#include "ContentHash.h"
 #include <QX11Info>
 #include <QFileInfo>
 #include <QMutexLocker>
@@ -44,6 +45,10 @@ int ImgPdfSink::open(const QString &path)
 	QFileInfo info(path);
 	setComicBookName(info.fileName(), path);
 
+	ContentHash h;
+	h.addFile(path);
+	setContentKey(h.result());
+
 	emit progress(1, 1);
 	return 0;
 }
@@ -72,6 +77,33 @@ QImage ImgPdfSink::image(unsigned int num, int &result)
 	return QImage();
 }
 
+QImage ImgPdfSink::thumbnailImage(unsigned int num, const QSize &size, int &result)
+{
+	result = 1;
+	QMutexLocker lock(&docmtx);
+	if (pdfdoc)
+	{
+		Poppler::Page* pdfpage = pdfdoc->page(num);
+		if (pdfpage)
+		{
+			//
+			// render at resolution just big enough for the thumbnail instead of screen resolution
+			const QSizeF pts(pdfpage->pageSizeF()); // in 1/72 inch
+			double dpi = 72.0;
+			if (pts.width() > 0 && pts.height() > 0)
+			{
+				dpi = 72.0 * qMin(size.width() / pts.width(), size.height() / pts.height());
+			}
+			dpi = qMin(dpi, static_cast<double>(QX11Info::appDpiX()));
+			QImage img = pdfpage->renderToImage(dpi, dpi);
+			delete pdfpage;
+			result = 0;
+			return img;
+		}
+	}
+	return QImage();
+}
+
 int ImgPdfSink::numOfImages() const
 {
 	QMutexLocker lock(&docmtx);
@@ -29,6 +29,7 @@ namespace QComicBook
 			int open(const QString &path);
 			void close();
 			QImage image(unsigned int num, int &result);
+			QImage thumbnailImage(unsigned int num, const QSize &size, int &result);
 			int numOfImages() const;
 			QString getName(int maxlen = 50) { return ""; }
 			QString getFullName() const { return ""; }
@@ -14,19 +14,34 @@
 #include "ImgCache.h"
 #include "../Page.h"
 #include "Thumbnail.h"
+#include "ThumbnailDatabase.h"
+#include "ContentHash.h"
 #include <QImage>
+#include <QSize>
+#include <QMutexLocker>
 #include "../ComicBookDebug.h"
 
 using namespace QComicBook;
 
+namespace
+{
+	//! Tells if palette color is kept by Format_Grayscale8; unlike qIsGray() it rejects transparent colors.
+	inline bool isGray(QRgb p)
+	{
+		return qIsGray(p) && qAlpha(p) == 255;
+	}
+}
+
 ImgSink::ImgSink(int cacheSize): cbname(QString::null), cbfullname(QString::null), QObject()
 {
 	cache = new ImgCache(cacheSize);
+	thumbs = new ThumbnailDatabase();
 }
 
 ImgSink::~ImgSink()
 {
     _DEBUG;
+    delete thumbs;
     delete cache;
 }
 
@@ -35,57 +50,179 @@ void ImgSink::setCacheSize(int cacheSize, bool autoAdjust)
 	cache->setSize(cacheSize, autoAdjust);
 }
 
-Page ImgSink::getImage(unsigned int num, int &result)
+PageFuture ImgSink::requestPage(unsigned int num, const CancellationToken &token)
 {
-	QImage im;
-	if (cache->get(num, im))
+	QMutexLocker lock(&inflightMtx);
+	QSharedPointer<PageFutureData> d(inflight.value(num).toStrongRef());
+	if (d && d->token.isCancelled())
+	{
+		d.clear(); // abandoned decode is being aborted, start over
+	}
+	if (!d)
 	{
-		result = 0;
-		_DEBUG << "from cache:" << num;
+		d = QSharedPointer<PageFutureData>(new PageFutureData(this, num));
+		QImage im;
+		if (cache->get(num, im))
+		{
+			_DEBUG << "from cache:" << num;
+			d->image = im;
+			d->state = PageFutureData::Finished;
+			return PageFuture(d, token);
+		}
+		inflight.insert(num, d);
 	}
 	else
 	{
-		im = image(num, result); //TODO check result
-		cache->insertImage(num, im);
-		_DEBUG << "to cache:" << num;
+		_DEBUG << "joining request:" << num;
+	}
+	return PageFuture(d, token);
+}
+
+PageFuture ImgSink::findPage(unsigned int num)
+{
+	QMutexLocker lock(&inflightMtx);
+	QSharedPointer<PageFutureData> d(inflight.value(num).toStrongRef());
+	return (d && !d->token.isCancelled()) ? PageFuture(d, CancellationToken()) : PageFuture();
+}
+
+void ImgSink::decodePage(const QSharedPointer<PageFutureData> &d)
+{
+	int result;
+	const QImage im(compactImage(image(d->num, result, d->token)));
+	if (result == SINKERR_CANCELLED)
+	{
+		_DEBUG << "decoding cancelled:" << d->num;
+	}
+	else if (result == 0)
+	{
+		cache->insertImage(d->num, im);
+		_DEBUG << "to cache:" << d->num;
+	}
+
+	inflightMtx.lock();
+	if (inflight.value(d->num) == d)
+	{
+		inflight.remove(d->num);
+	}
+	inflightMtx.unlock();
+
+	d->mtx.lock();
+	d->image = im;
+	d->result = result;
+	d->state = PageFutureData::Finished;
+	d->mtx.unlock();
+	d->finished.wakeAll();
+}
+
+QImage ImgSink::compactImage(const QImage &img)
+{
+	//
+	// only exact grays are converted, so the page looks the same as decoded
+	switch (img.format())
+	{
+		case QImage::Format_RGB32:
+			if (!img.allGray()) // stops at first colored pixel, most pages with colors are rejected by first rows
+				return img;
+			break;
+		case QImage::Format_Indexed8:
+			{
+				const QVector<QRgb> colors(img.colorTable());
+				for (int i=0; i<colors.count(); i++)
+					if (!isGray(colors[i]))
+						return img;
+			}
+			break;
+		default: // already compact, has alpha or too uncommon to bother
+			return img;
 	}
-	const Page page(num, im);
-	return page;
+	_DEBUG << "grayscale page" << img.size();
+	return img.convertToFormat(QImage::Format_Grayscale8);
+}
+
+Page ImgSink::getImage(unsigned int num, int &result, const CancellationToken &token)
+{
+	for (;;)
+	{
+		PageFuture f(requestPage(num, token));
+		const Page page(f.result(&result));
+		//
+		// decode may have been aborted by other consumers just as this one joined
+		if (result != SINKERR_CANCELLED || token.isCancelled())
+		{
+			return page;
+		}
+	}
+}
+
+QImage ImgSink::image(unsigned int num, int &result, const CancellationToken &)
+{
+	return image(num, result);
+}
+
+QImage ImgSink::thumbnailImage(unsigned int num, const QSize &size, int &result)
+{
+	return image(num, result);
 }
 
 Thumbnail ImgSink::getThumbnail(unsigned int num, bool thumbcache)
 {
-        Thumbnail t(num, cbname.remove('/'));
+        Thumbnail t(num);
 
         //
         // try to load cached thumbnail
         if (thumbcache)
         {
-            if (t.tryLoad())
+            thumbcache = thumbs->open(contentKey(), numOfImages());
+            if (thumbcache && thumbs->get(num, t))
             {
                 _DEBUG << "thumbnail" << num << "loaded from disk";
                 return t;
             }
         }
 
-		int result;
+		int result = 0;
         //
-        // try to load image
-        const Page p(getImage(num, result));
+        // use page image if already cached, otherwise decode it at reduced size
+        QImage img;
+        if (!cache->get(num, img))
+        {
+            //
+            // join page decoded for another consumer, if any
+            PageFuture f(findPage(num));
+            if (f.isValid())
+                img = f.result(&result).getImage();
+            else
+                img = thumbnailImage(num, QSize(Thumbnail::maxWidth(), Thumbnail::maxHeight()), result);
+        }
 		if (result == 0)
         {
-			t.setImage(p.getImage());
+			t.setImage(img);
             //
             // save thumbnail if caching enabled
             if (thumbcache)
             {
-                t.save();
+                thumbs->put(t);
             }
         }
 
         return t;
 }
 
+Thumbnail ImgSink::makeThumbnail(const Page &page, bool thumbcache)
+{
+	Thumbnail t(page.getNumber());
+	t.setImage(page.getImage());
+	if (thumbcache && thumbs->open(contentKey(), numOfImages()))
+	{
+		thumbs->put(t);
+	}
+	return t;
+}
+
+void ImgSink::flushThumbnails()
+{
+	thumbs->flush();
+}
 
 void ImgSink::setComicBookName(const QString &name, const QString &fullName)
 {
@@ -98,6 +235,24 @@ QString ImgSink::getFullName() const
 	return cbfullname;
 }
 
+void ImgSink::setContentKey(const QByteArray &key)
+{
+	cbkey = key;
+}
+
+QByteArray ImgSink::contentKey() const
+{
+	if (cbkey.isEmpty())
+	{
+		//
+		// fallback for sinks that couldn't read their contents
+		ContentHash h;
+		h.add(cbfullname.toUtf8());
+		return h.result();
+	}
+	return cbkey;
+}
+
 QString ImgSink::getName(int maxlen) const
 {
 	if (cbname.length() < maxlen)
@@ -14,14 +14,21 @@
 #define __IMGSINK_H
 
 #include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QWeakPointer>
+#include "PageFuture.h"
 
 class QImage;
+class QSize;
 
 namespace QComicBook
 {
 	class Page;
 	class Thumbnail;
 	class ImgCache;
+	class ThumbnailDatabase;
 
 	//! Possible errors.
 	enum SinkError
@@ -35,7 +42,8 @@ namespace QComicBook
 		SINKERR_NOTDIR,    //!<not a directory
 		SINKERR_EMPTY,     //!<no images inside
 		SINKERR_ARCHEXIT, //!<archiver exited with error
-		SINKERR_OTHER  //!<another kind of error
+		SINKERR_OTHER,  //!<another kind of error
+		SINKERR_CANCELLED //!<loading was cancelled
 	};
 		
 	class ImgSink: public QObject
@@ -70,12 +78,40 @@ namespace QComicBook
 			*/
 			virtual QImage image(unsigned int num, int &result) = 0;
 
+			//! Returns given page, giving up early if token gets cancelled.
+			/*! Default implementation can't be interrupted and just calls image().
+			 *  @param result contains 0 on success, SINKERR_CANCELLED if cancelled or other error */
+			virtual QImage image(unsigned int num, int &result, const CancellationToken &token);
+
+			//! Returns given page downscaled for thumbnail generation.
+			/*! The image is not put in the cache. Subclasses may decode or render the page
+			 *  at reduced resolution; default implementation returns full image().
+			 *  @param num page number
+			 *  @param size thumbnail size; returned image is not smaller than needed to fit it
+			 *  @param result contains 0 on succes or value greater than 0 for error */
+			virtual QImage thumbnailImage(unsigned int num, const QSize &size, int &result);
+
+			//! Requests given page.
+			/*! Requests for a page that is being decoded share the same decode;
+			 *  page found in the cache gives finished future.
+			 *  @param num page number
+			 *  @param token consumer token of returned handle; cancelling it is the same as PageFuture::cancel()
+			 *  @return handle of the page
+			 *  @see PageFuture */
+			PageFuture requestPage(unsigned int num, const CancellationToken &token = CancellationToken());
+
+			//! Returns handle of given page if it's being decoded, invalid handle otherwise.
+			PageFuture findPage(unsigned int num);
+
 			//! Returns an image for specified page.
-			/*! The cache is first checked for image. If not found, the image is loaded.
+			/*! Blocking version of requestPage().
+			 *  The cache is first checked for image. If not found, the image is loaded.
 			 *  @param num page number
 			 *  @param result contains 0 on succes or value greater than 0 for error
+			 *  @param token cancelling it from another thread makes the call return early with SINKERR_CANCELLED,
+			 *  unless other consumers still wait for the page
 			 *  @return an image */
-			virtual Page getImage(unsigned int num, int &result);
+			virtual Page getImage(unsigned int num, int &result, const CancellationToken &token = CancellationToken());
 
 			//! Returns thumbnail image for specified page.
 			/*! Thumbnail is loaded from disk if found and caching is enabled. Otherwise,
@@ -84,8 +120,21 @@ namespace QComicBook
 			 *  @param thumbcache specifies if thumbnails disk cache should be used */
 			virtual Thumbnail getThumbnail(unsigned int num, bool thumbcache=true);
 
+			//! Makes thumbnail of already decoded page.
+			/*! @param page decoded page
+			 *  @param thumbcache specifies if thumbnail should be stored in disk cache */
+			virtual Thumbnail makeThumbnail(const Page &page, bool thumbcache=true);
+
+			//! Writes thumbnails generated so far to disk cache.
+			void flushThumbnails();
+
 			/*! @return number of images for this comic book sink */
 			virtual int numOfImages() const = 0;
+
+			//! Returns how many pages may be loaded from this sink at the same time.
+			/*! Default is 1 for sinks that serialize access to their internals.
+			 *  @see LoaderThreadBase::setWorkers */
+			virtual int maxConcurrency() const { return 1; }
 			
 			void setComicBookName(const QString &name, const QString &fullName);
 
@@ -99,6 +148,10 @@ namespace QComicBook
 			 *  @return name of comic book */
 			QString getFullName() const;
 
+			//! Returns content identity of the comic book, shared by disk caches.
+			/*! @see ContentHash */
+			QByteArray contentKey() const;
+
 			virtual QString getFullFileName(int page) const = 0;
 
 			/*! @return contents of .nfo and file_id.diz files; file name goes first, then contents. */
@@ -115,10 +168,26 @@ namespace QComicBook
 
 			virtual QString getPrevious() const = 0;
 
+		protected:
+			void setContentKey(const QByteArray &key);
+
 		private:
+			friend class PageFuture;
+			//! Decodes page of future, puts it in the cache and finishes the future.
+			void decodePage(const QSharedPointer<PageFutureData> &d);
+			//! Converts grayscale page to Format_Grayscale8, so it takes a quarter of memory in the cache.
+			/*! Only pages of exact, opaque grays are converted. Other palette and monochrome images
+			 *  are kept as they were decoded; they are expanded to 32 bits only when drawn. */
+			static QImage compactImage(const QImage &img);
+
+			QHash<int, QWeakPointer<PageFutureData> > inflight; //!< pages being requested
+			QMutex inflightMtx;
+
 			ImgCache *cache;
+			ThumbnailDatabase *thumbs; //!< thumbnails disk cache
 			QString cbname; //!< comic book name
 			QString cbfullname; //!< full comic book name (e.g. path)
+			QByteArray cbkey; //!< comic book content identity
 	};
 }
 
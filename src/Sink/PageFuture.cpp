@@ -0,0 +1,178 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2010 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+#include "PageFuture.h"
+#include "ImgSink.h"
+#include "../Page.h"
+#include <QThreadPool>
+#include <QRunnable>
+#include <QMutexLocker>
+
+namespace QComicBook
+{
+    //! Decodes page in background; not a consumer, so it doesn't keep the decode alive.
+    class PageFutureTask: public QRunnable
+    {
+        public:
+            PageFutureTask(const QSharedPointer<PageFutureData> &d): d(d) {}
+            virtual void run()
+            {
+                if (!d->token.isCancelled())
+                {
+                    PageFuture::result(d, 0);
+                }
+            }
+
+        private:
+            const QSharedPointer<PageFutureData> d;
+    };
+}
+
+using namespace QComicBook;
+
+PageFutureData::PageFutureData(ImgSink *sink, int num)
+    : sink(sink)
+    , num(num)
+    , state(Pending)
+    , handles(0)
+    , result(0)
+{
+}
+
+PageFuture::PageFuture()
+{
+}
+
+PageFuture::PageFuture(const QSharedPointer<PageFutureData> &d, const CancellationToken &token)
+    : d(d)
+    , token(token)
+{
+    d->handles.ref();
+    d->token.addSource(token);
+}
+
+PageFuture::PageFuture(const PageFuture &f)
+    : d(f.d)
+    , token(f.token)
+{
+    if (d)
+    {
+        d->handles.ref();
+    }
+}
+
+PageFuture& PageFuture::operator=(const PageFuture &f)
+{
+    if (d != f.d)
+    {
+        release();
+        d = f.d;
+        if (d)
+        {
+            d->handles.ref();
+        }
+    }
+    token = f.token;
+    return *this;
+}
+
+PageFuture::~PageFuture()
+{
+    release();
+}
+
+void PageFuture::release()
+{
+    if (d && !d->handles.deref())
+    {
+        d->token.cancel();
+    }
+}
+
+bool PageFuture::isValid() const
+{
+    return !d.isNull();
+}
+
+bool PageFuture::isFinished() const
+{
+    if (!d)
+    {
+        return false;
+    }
+    QMutexLocker lock(&d->mtx);
+    return d->state == PageFutureData::Finished;
+}
+
+bool PageFuture::isCancelled() const
+{
+    if (!d)
+    {
+        return false;
+    }
+    QMutexLocker lock(&d->mtx);
+    return d->state != PageFutureData::Finished ? d->token.isCancelled() : d->result == SINKERR_CANCELLED;
+}
+
+int PageFuture::pageNumber() const
+{
+    return d ? d->num : -1;
+}
+
+Page PageFuture::result(int *result)
+{
+    if (!d)
+    {
+        if (result)
+            *result = SINKERR_OTHER;
+        return Page();
+    }
+    return PageFuture::result(d, result);
+}
+
+Page PageFuture::result(const QSharedPointer<PageFutureData> &d, int *result)
+{
+    d->mtx.lock();
+    if (d->state == PageFutureData::Pending)
+    {
+        d->state = PageFutureData::Running;
+        d->mtx.unlock();
+        d->sink->decodePage(d); // sets state to Finished
+        d->mtx.lock();
+    }
+    while (d->state != PageFutureData::Finished)
+    {
+        d->finished.wait(&d->mtx);
+    }
+    const QImage img(d->image);
+    if (result)
+        *result = d->result;
+    d->mtx.unlock();
+
+    return Page(d->num, img);
+}
+
+void PageFuture::start()
+{
+    if (d && !isFinished())
+    {
+        QThreadPool::globalInstance()->start(new PageFutureTask(d));
+    }
+}
+
+void PageFuture::cancel()
+{
+    if (d)
+    {
+        token.cancel();
+    }
+}
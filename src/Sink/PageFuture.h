@@ -0,0 +1,103 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2010 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+#ifndef __PAGEFUTURE_H
+#define __PAGEFUTURE_H
+
+#include <QSharedPointer>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
+#include <QImage>
+#include "CancellationToken.h"
+
+namespace QComicBook
+{
+	class ImgSink;
+	class Page;
+
+	//! Shared state of a page requested from ImgSink.
+	class PageFutureData
+	{
+		public:
+			enum State
+			{
+				Pending, //!< not decoded yet
+				Running, //!< being decoded
+				Finished
+			};
+
+			PageFutureData(ImgSink *sink, int num);
+
+			ImgSink *sink;
+			const int num;
+			QMutex mtx;
+			QWaitCondition finished;
+			State state;
+			CancellationToken token; //!< cancelled when all consumers cancel or all handles are gone; aborts running decode
+			QAtomicInt handles; //!< number of PageFuture handles
+			QImage image;
+			int result;
+	};
+
+	class PageFutureTask;
+
+	//! Handle of a page requested with ImgSink::requestPage().
+	/*! All handles of the same page share one decode: the first consumer that needs
+	 *  the image (result() or start()) decodes it and the others wait for it.
+	 *  Copies of a handle are the same consumer; decoding is dropped when the last
+	 *  handle of the page is destroyed. Handles must not outlive the sink they were obtained from.
+	 */
+	class PageFuture
+	{
+		public:
+			PageFuture();
+			PageFuture(const PageFuture &f);
+			PageFuture& operator=(const PageFuture &f);
+			~PageFuture();
+
+			bool isValid() const;
+			bool isFinished() const;
+			//! @return true if all consumers cancelled before decoding finished
+			bool isCancelled() const;
+			int pageNumber() const;
+
+			//! Returns the page, decoding it or waiting for another consumer to decode it.
+			/*! If all consumers cancel while the page is being decoded, decoding stops early
+			 *  and result is SINKERR_CANCELLED.
+			 *  @param result receives 0 on success or value greater than 0 for error */
+			Page result(int *result = 0);
+
+			//! Decodes the page in background if nobody has started it yet.
+			void start();
+
+			//! Withdraws this consumer; may be called from any thread.
+			/*! Decoding is dropped, or aborted if it's running, when no consumers are left. */
+			void cancel();
+
+		private:
+			friend class ImgSink;
+			friend class PageFutureTask;
+			//! @param token consumer token of this handle
+			PageFuture(const QSharedPointer<PageFutureData> &d, const CancellationToken &token);
+
+			//! Drops this handle; cancels decoding if it was the last one.
+			void release();
+
+			static Page result(const QSharedPointer<PageFutureData> &d, int *result);
+
+			QSharedPointer<PageFutureData> d;
+			CancellationToken token; //!< this consumer
+	};
+}
+
+#endif
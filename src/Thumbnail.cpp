@@ -11,9 +11,6 @@
  */
 
 #include "Thumbnail.h"
-#include <QCryptographicHash>
-#include <ComicBookSettings.h>
-#include <Utility.h>
 
 using namespace QComicBook;
 
@@ -25,10 +22,9 @@ Thumbnail::Thumbnail()
 {
 }
 
-Thumbnail::Thumbnail(int n, const QString &comicbookName)
+Thumbnail::Thumbnail(int n)
   : num(n)
 {
-    hash = getScrambledName(comicbookName + "." + QString::number(n));
 }
 
 Thumbnail::Thumbnail(int n, const QImage &i): num(n)
@@ -38,7 +34,6 @@ Thumbnail::Thumbnail(int n, const QImage &i): num(n)
 
 Thumbnail::Thumbnail(const Thumbnail &t)
     : num(t.num)
-    , hash(t.hash)
     , img(t.img)
 {
 }
@@ -57,19 +52,6 @@ const QImage& Thumbnail::image() const
 	return img;
 }
 
-bool Thumbnail::tryLoad()
-{
-    QImage tmp;
-    const QString fname(getFullPath());
-    if (tmp.load(fname))
-    {
-        Utility::touch(fname);
-        setImage(tmp);
-        return true;
-    }
-    return false;
-}
-
 bool Thumbnail::fromOriginalImage(const QString &fname)
 {
     const QImage i(fname);
@@ -79,11 +61,6 @@ bool Thumbnail::fromOriginalImage(const QString &fname)
     return true;
 }
 
-bool Thumbnail::save()
-{
-    return img.save(getFullPath(), "JPEG", 75);
-}
-
 void Thumbnail::setImage(const QImage &i)
 {
 	if (i.width() > thwidth || i.height() > thheight)
@@ -101,13 +78,3 @@ int Thumbnail::maxHeight()
 {
 	return thheight;
 }
-
-QString Thumbnail::getFullPath() const
-{
-    return ComicBookSettings::instance().thumbnailsDir() + "/" + hash.toHex() + ".jpg";
-}
-
-QByteArray Thumbnail::getScrambledName(const QString &in)
-{
-    return QCryptographicHash::hash( in.toLatin1(), QCryptographicHash::Sha1 );
-}
@@ -14,7 +14,6 @@
 #define __THUMBNAIL_H
 
 #include <QImage>
-#include <QByteArray>
 #include <QMetaType>
 
 namespace QComicBook
@@ -23,25 +22,20 @@ namespace QComicBook
 	{
 		private:
 			int num;
-			QByteArray hash;
 			QImage img;
 			static int thwidth, thheight; //default thumbnail width and height
-			static QByteArray getScrambledName(const QString &in);
 
 		public:
 			Thumbnail();
-			Thumbnail(int n, const QString &comicbookName);
+			explicit Thumbnail(int n);
 			Thumbnail(int n, const QImage &i);
 			Thumbnail(const Thumbnail &t);
 			~Thumbnail();
 
 			int page() const;
 			const QImage& image() const;
-			bool tryLoad();
 			bool fromOriginalImage(const QString &fname);
-			bool save();
 			void setImage(const QImage &i);
-			QString getFullPath() const;
 
 			static int maxWidth();
 			static int maxHeight();
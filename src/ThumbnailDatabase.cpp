@@ -0,0 +1,316 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2010 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+#include "ThumbnailDatabase.h"
+#include "Thumbnail.h"
+#include "ComicBookSettings.h"
+#include "Utility.h"
+#include "ComicBookDebug.h"
+#include <QDir>
+#include <QSaveFile>
+#include <QBuffer>
+#include <QImage>
+#include <QDataStream>
+#include <QMutexLocker>
+#include <QtEndian>
+
+using namespace QComicBook;
+
+const quint32 ThumbnailDatabase::MAGIC = 0x51435448; // "QCTH"
+const quint32 ThumbnailDatabase::VERSION = 1;
+const int ThumbnailDatabase::HEADER_SIZE = 12;
+const int ThumbnailDatabase::ENTRY_SIZE = 8;
+const int ThumbnailDatabase::FLUSH_BATCH = 32;
+
+ThumbnailDatabase::ThumbnailDatabase()
+    : m_data(NULL)
+    , m_mapSize(0)
+    , m_pages(0)
+{
+}
+
+ThumbnailDatabase::~ThumbnailDatabase()
+{
+    close();
+}
+
+bool ThumbnailDatabase::open(const QByteArray &key, int numOfPages)
+{
+    QMutexLocker lock(&m_mtx);
+
+    const QString fname(ComicBookSettings::instance().thumbnailsDir() + "/" + key + ".qct");
+    if (m_file.isOpen())
+    {
+        if (m_file.fileName() == fname)
+        {
+            return true;
+        }
+        closeFile();
+    }
+
+    m_pages = numOfPages;
+    m_file.setFileName(fname);
+    if (!m_file.open(QIODevice::ReadWrite))
+    {
+        _DEBUG << "can't open" << fname;
+        return false;
+    }
+
+    bool valid = false;
+    if (m_file.size() >= HEADER_SIZE + ENTRY_SIZE * m_pages)
+    {
+        QDataStream str(&m_file);
+        quint32 magic, version, pages;
+        str >> magic >> version >> pages;
+        valid = (magic == MAGIC && version == VERSION && static_cast<int>(pages) == m_pages);
+    }
+    if (!valid && !create(QMap<int, QByteArray>()))
+    {
+        m_file.close();
+        return false;
+    }
+    Utility::touch(fname); // mark as recently used for removeLeastRecentlyUsed()
+    map();
+
+    _DEBUG << "opened" << fname;
+    return true;
+}
+
+void ThumbnailDatabase::close()
+{
+    QMutexLocker lock(&m_mtx);
+    closeFile();
+}
+
+void ThumbnailDatabase::closeFile()
+{
+    writePending();
+    unmap();
+    if (m_file.isOpen())
+    {
+        m_file.close();
+    }
+}
+
+bool ThumbnailDatabase::get(int page, Thumbnail &t)
+{
+    //
+    // only encoded data is fetched under the lock; decoding would block other loader workers
+    QByteArray data;
+    m_mtx.lock();
+    if (page >= 0 && page < m_pages)
+    {
+        const QMap<int, QByteArray>::const_iterator it = m_pending.constFind(page);
+        if (it != m_pending.constEnd())
+        {
+            data = it.value();
+        }
+        else
+        {
+            quint32 offset, size;
+            if (entry(page, offset, size))
+            {
+                data = QByteArray(reinterpret_cast<const char *>(m_data + offset), size);
+            }
+        }
+    }
+    m_mtx.unlock();
+
+    if (data.isEmpty())
+    {
+        return false;
+    }
+    QImage img;
+    if (!img.loadFromData(data, "JPEG"))
+    {
+        return false;
+    }
+    t.setImage(img);
+    return true;
+}
+
+bool ThumbnailDatabase::entry(int page, quint32 &offset, quint32 &size) const
+{
+    if (!m_data)
+    {
+        return false;
+    }
+    const uchar *e = m_data + HEADER_SIZE + page * ENTRY_SIZE;
+    offset = qFromBigEndian<quint32>(e);
+    size = qFromBigEndian<quint32>(e + 4);
+    return size > 0 && offset + static_cast<qint64>(size) <= m_mapSize;
+}
+
+void ThumbnailDatabase::put(const Thumbnail &t)
+{
+    QByteArray data;
+    QBuffer buf(&data);
+    buf.open(QIODevice::WriteOnly);
+    if (!t.image().save(&buf, "JPEG", 75))
+    {
+        return;
+    }
+
+    m_mtx.lock();
+    if (t.page() < 0 || t.page() >= m_pages)
+    {
+        m_mtx.unlock();
+        return;
+    }
+    m_pending.insert(t.page(), data);
+    const bool full = m_pending.count() >= FLUSH_BATCH;
+    m_mtx.unlock();
+
+    if (full)
+    {
+        flush();
+    }
+}
+
+void ThumbnailDatabase::flush()
+{
+    QMutexLocker lock(&m_mtx);
+    writePending();
+}
+
+void ThumbnailDatabase::writePending()
+{
+    if (m_pending.isEmpty() || !m_file.isOpen())
+    {
+        return;
+    }
+
+    //
+    // rewritten thumbnails leave their old data behind; once it outweighs the data still in use,
+    // file is recreated with kept and queued thumbnails
+    qint64 kept = 0;
+    for (int i=0; i<m_pages; i++)
+    {
+        quint32 offset, size;
+        if (!m_pending.contains(i) && entry(i, offset, size))
+        {
+            kept += size;
+        }
+    }
+    const qint64 garbage = m_mapSize - HEADER_SIZE - ENTRY_SIZE * m_pages - kept;
+    const bool compact = m_data && garbage > kept;
+    if (compact)
+    {
+        _DEBUG << "compacting thumbnails file," << garbage << "bytes unused";
+        for (int i=0; i<m_pages; i++)
+        {
+            quint32 offset, size;
+            if (!m_pending.contains(i) && entry(i, offset, size))
+            {
+                m_pending.insert(i, QByteArray(reinterpret_cast<const char *>(m_data + offset), size));
+            }
+        }
+    }
+
+    _DEBUG << "writing" << m_pending.count() << "thumbnails";
+
+    unmap();
+    if (compact && create(m_pending))
+    {
+        m_pending.clear();
+        map();
+        return;
+    }
+
+    QDataStream str(&m_file);
+    for (QMap<int, QByteArray>::const_iterator it = m_pending.constBegin(); it != m_pending.constEnd(); ++it)
+    {
+        const qint64 offset = m_file.size();
+        if (!m_file.seek(offset) || m_file.write(it.value()) != it.value().size())
+        {
+            break;
+        }
+        //
+        // entry is updated after data is written, so an interrupted write leaves it empty
+        m_file.seek(HEADER_SIZE + it.key() * ENTRY_SIZE);
+        str << static_cast<quint32>(offset) << static_cast<quint32>(it.value().size());
+    }
+    m_file.flush();
+    m_pending.clear();
+
+    map();
+}
+
+bool ThumbnailDatabase::create(const QMap<int, QByteArray> &thumbs)
+{
+    //
+    // new file replaces the old one only once it's complete, so an interrupted write loses nothing,
+    // and other instances that have the old file mapped keep reading it
+    QSaveFile f(m_file.fileName());
+    if (!f.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+
+    QByteArray table(ENTRY_SIZE * m_pages, 0);
+    quint32 offset = HEADER_SIZE + table.size();
+    for (QMap<int, QByteArray>::const_iterator it = thumbs.constBegin(); it != thumbs.constEnd(); ++it)
+    {
+        uchar *entry = reinterpret_cast<uchar *>(table.data()) + it.key() * ENTRY_SIZE;
+        qToBigEndian<quint32>(offset, entry);
+        qToBigEndian<quint32>(it.value().size(), entry + 4);
+        offset += it.value().size();
+    }
+
+    QDataStream str(&f);
+    str << MAGIC << VERSION << static_cast<quint32>(m_pages);
+    str.writeRawData(table.constData(), table.size());
+    for (QMap<int, QByteArray>::const_iterator it = thumbs.constBegin(); it != thumbs.constEnd(); ++it)
+    {
+        str.writeRawData(it.value().constData(), it.value().size());
+    }
+    if (str.status() != QDataStream::Ok || !f.commit())
+    {
+        return false;
+    }
+
+    //
+    // reopened, as file that was open is the replaced one
+    m_file.close();
+    return m_file.open(QIODevice::ReadWrite);
+}
+
+void ThumbnailDatabase::map()
+{
+    m_mapSize = m_file.size();
+    m_data = m_file.map(0, m_mapSize);
+}
+
+void ThumbnailDatabase::unmap()
+{
+    if (m_data)
+    {
+        m_file.unmap(m_data);
+        m_data = NULL;
+    }
+    m_mapSize = 0;
+}
+
+void ThumbnailDatabase::removeLeastRecentlyUsed(qint64 maxSize)
+{
+    const QString thdir(ComicBookSettings::instance().thumbnailsDir());
+
+    //
+    // remove thumbnails saved by previous versions
+    QDir dir(thdir, "*.jpg", QDir::Unsorted, QDir::Files|QDir::NoSymLinks);
+    foreach (const QString &f, dir.entryList())
+    {
+        dir.remove(f);
+    }
+
+    Utility::removeLeastRecentlyUsed(thdir, "*.qct", maxSize);
+}
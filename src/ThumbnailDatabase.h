@@ -0,0 +1,94 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2010 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+/*! \file ThumbnailDatabase.h */
+
+#ifndef __THUMBNAILDATABASE_H
+#define __THUMBNAILDATABASE_H
+
+#include <QFile>
+#include <QMap>
+#include <QMutex>
+#include <QByteArray>
+
+namespace QComicBook
+{
+	class Thumbnail;
+
+	//! Disk cache of thumbnails of one comic book.
+	/*! All thumbnails of a comic book are packed in a single file in thumbnails
+	 *  directory: a header, a table of (offset, size) entries indexed by page
+	 *  number and JPEG data of thumbnails. The file is memory-mapped for reading;
+	 *  new thumbnails are queued and appended in batches by flush(). Data of
+	 *  rewritten thumbnails stays in the file until it outweighs the data in use;
+	 *  flush() then writes a new file and renames it over the old one.
+	 */
+	class ThumbnailDatabase
+	{
+		public:
+			ThumbnailDatabase();
+			~ThumbnailDatabase();
+
+			//! Opens (or creates) thumbnails file of given comic book.
+			/*! Existing file is discarded if it was created for different number of pages.
+			 *  @param key comic book content identity (see ImgSink::contentKey())
+			 *  @param numOfPages number of pages of comic book
+			 *  @return true if thumbnails file is usable */
+			bool open(const QByteArray &key, int numOfPages);
+
+			//! Flushes queued thumbnails and closes thumbnails file.
+			void close();
+
+			//! Loads thumbnail of given page.
+			/*! @return true if thumbnail was found */
+			bool get(int page, Thumbnail &t);
+
+			//! Queues thumbnail for writing; it's written on next flush().
+			void put(const Thumbnail &t);
+
+			//! Writes all queued thumbnails to thumbnails file.
+			void flush();
+
+			//! Removes least recently used thumbnails files exceeding given total size.
+			/*! Thumbnails saved by older versions (one file per page) are removed as well.
+			 *  @param maxSize maximum total size of thumbnails files in bytes */
+			static void removeLeastRecentlyUsed(qint64 maxSize);
+
+		private:
+			//! Replaces thumbnails file with new one holding given thumbnails and reopens it.
+			bool create(const QMap<int, QByteArray> &thumbs);
+			//! Writes queued thumbnails; called with m_mtx locked.
+			void writePending();
+			//! Writes queued thumbnails and closes file; called with m_mtx locked.
+			void closeFile();
+			//! Reads entry of given page from mapped file.
+			/*! @return false if there is no valid thumbnail data */
+			bool entry(int page, quint32 &offset, quint32 &size) const;
+			void map();
+			void unmap();
+
+			static const quint32 MAGIC;
+			static const quint32 VERSION;
+			static const int HEADER_SIZE; //!< magic, version, number of pages
+			static const int ENTRY_SIZE; //!< offset and size of thumbnail data
+			static const int FLUSH_BATCH; //!< number of queued thumbnails that triggers flush
+
+			QFile m_file;
+			uchar *m_data; //!< mapped thumbnails file
+			qint64 m_mapSize;
+			int m_pages;
+			QMap<int, QByteArray> m_pending; //!< encoded thumbnails waiting for flush
+			QMutex m_mtx;
+	};
+}
+
+#endif
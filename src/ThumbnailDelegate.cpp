@@ -0,0 +1,76 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2010 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+#include "ThumbnailDelegate.h"
+#include "ThumbnailsModel.h"
+#include "Thumbnail.h"
+#include <QPainter>
+#include <QApplication>
+#include <QStyle>
+
+using namespace QComicBook;
+
+const int ThumbnailDelegate::MARGIN = 4;
+
+ThumbnailDelegate::ThumbnailDelegate(const ThumbnailsModel *model, QObject *parent)
+	: QStyledItemDelegate(parent)
+	, model(model)
+{
+}
+
+ThumbnailDelegate::~ThumbnailDelegate()
+{
+}
+
+void ThumbnailDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+	QStyleOptionViewItem opt(option);
+	initStyleOption(&opt, index);
+
+	//
+	// let the style draw background and selection only
+	const QString text(opt.text);
+	opt.text = QString::null;
+	const QWidget *widget = opt.widget;
+	QStyle *style = widget ? widget->style() : QApplication::style();
+	style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, widget);
+
+	const int thw = Thumbnail::maxWidth();
+	const int thh = Thumbnail::maxHeight();
+	const QRect iconRect(opt.rect.x() + (opt.rect.width() - thw) / 2, opt.rect.y() + MARGIN, thw, thh);
+
+	painter->save();
+	const QPixmap *atlas;
+	QRect src;
+	if (model->thumbnail(index.row(), atlas, src))
+	{
+		const QPoint pos(iconRect.x() + (thw - src.width()) / 2, iconRect.y() + (thh - src.height()) / 2);
+		painter->drawPixmap(QRect(pos, src.size()), *atlas, src);
+	}
+	else
+	{
+		//
+		// "empty page" placeholder
+		painter->fillRect(iconRect, Qt::white);
+		painter->setPen(QPen(Qt::black, 3));
+		painter->drawRect(iconRect);
+	}
+
+	painter->setPen(opt.palette.color((opt.state & QStyle::State_Selected) ? QPalette::HighlightedText : QPalette::Text));
+	painter->drawText(QRect(opt.rect.x(), iconRect.bottom() + MARGIN, opt.rect.width(), opt.fontMetrics.height()), Qt::AlignHCenter|Qt::AlignTop, text);
+	painter->restore();
+}
+
+QSize ThumbnailDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &) const
+{
+	return QSize(Thumbnail::maxWidth() + 2 * MARGIN, Thumbnail::maxHeight() + 3 * MARGIN + option.fontMetrics.height());
+}
@@ -0,0 +1,38 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2010 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+#ifndef __THUMBNAILDELEGATE_H
+#define __THUMBNAILDELEGATE_H
+
+#include <QStyledItemDelegate>
+
+namespace QComicBook
+{
+	class ThumbnailsModel;
+
+	//! Draws thumbnails straight from atlases of ThumbnailsModel.
+	class ThumbnailDelegate: public QStyledItemDelegate
+	{
+		public:
+			ThumbnailDelegate(const ThumbnailsModel *model, QObject *parent = 0);
+			virtual ~ThumbnailDelegate();
+
+			virtual void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const;
+			virtual QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const;
+
+		private:
+			static const int MARGIN;
+			const ThumbnailsModel *model;
+	};
+}
+
+#endif
@@ -13,19 +13,28 @@
 #include "ThumbnailLoaderThread.h"
 #include "Sink/ImgDirSink.h"
 #include "Thumbnail.h"
+#include "Page.h"
 #include "ComicBookDebug.h"
+#include <QTimer>
  
 using namespace QComicBook;
 
-ThumbnailLoaderThread::ThumbnailLoaderThread(bool cache): LoaderThreadBase(), usecache(cache)
+const int ThumbnailLoaderThread::DELIVERY_INTERVAL = 16;
+
+ThumbnailLoaderThread::ThumbnailLoaderThread(bool cache): LoaderThreadBase(), usecache(cache), visibleFirst(-1), visibleLast(-1), scrollDirection(0), finishedGeneration(0)
 {
+    defaultPriority = PriorityThumbnail;
+    deliveryTimer = new QTimer(this);
+    deliveryTimer->setSingleShot(true);
+    deliveryTimer->setInterval(DELIVERY_INTERVAL);
+    connect(deliveryTimer, SIGNAL(timeout()), this, SLOT(deliver()));
 }
 
 ThumbnailLoaderThread::~ThumbnailLoaderThread()
 {
 }
 
-bool ThumbnailLoaderThread::process(const LoadRequest &req)
+bool ThumbnailLoaderThread::process(const LoadRequest &req, const QSharedPointer<ImgSink> &sink)
 {
     if (req.twoPages)
     {                
@@ -34,12 +43,176 @@ bool ThumbnailLoaderThread::process(const LoadRequest &req)
     else
     {
         _DEBUG << "thumbnail requested: " << req.pageNumber;
-        const Thumbnail t = sink->getThumbnail(req.pageNumber, usecache);
-        emit thumbnailLoaded(t); //TODO errors
+
+        loaderMutex.lock();
+        const QImage img(decoded.take(req.pageNumber));
+        loaderMutex.unlock();
+
+        if (img.isNull())
+        {
+            const Thumbnail t = sink->getThumbnail(req.pageNumber, usecache);
+            addFinished(t, req.generation); //TODO errors
+        }
+        else
+        {
+            _DEBUG << "thumbnail from decoded page" << req.pageNumber;
+            const Thumbnail t = sink->makeThumbnail(Page(req.pageNumber, img), usecache);
+            addFinished(t, req.generation);
+        }
     }
     return true;
 }
 
+void ThumbnailLoaderThread::addFinished(const Thumbnail &t, int generation)
+{
+    mtx.lock();
+    if (generation != finishedGeneration)
+    {
+        mtx.unlock();
+        _DEBUG << "discarding thumbnail of previous sink" << t.page();
+        return;
+    }
+    const bool first = finished.isEmpty();
+    finished.append(t);
+    mtx.unlock();
+
+    //
+    // only the first thumbnail of a batch posts an event; the rest join it until the timer fires
+    if (first)
+    {
+        QMetaObject::invokeMethod(this, "scheduleDelivery", Qt::QueuedConnection);
+    }
+}
+
+void ThumbnailLoaderThread::scheduleDelivery()
+{
+    if (!deliveryTimer->isActive())
+    {
+        deliveryTimer->start();
+    }
+}
+
+void ThumbnailLoaderThread::deliver()
+{
+    mtx.lock();
+    const QList<Thumbnail> batch(finished);
+    finished.clear();
+    mtx.unlock();
+
+    if (!batch.isEmpty())
+    {
+        _DEBUG << "delivering" << batch.count() << "thumbnails";
+        emit thumbnailsLoaded(batch);
+    }
+}
+
+void ThumbnailLoaderThread::setSink(QSharedPointer<ImgSink> sink)
+{
+    LoaderThreadBase::setSink(sink);
+
+    loaderMutex.lock();
+    decoded.clear();
+    const int gen = generation;
+    loaderMutex.unlock();
+
+    //
+    // drop thumbnails of previous sink that weren't delivered yet, and the ones still being made
+    mtx.lock();
+    finished.clear();
+    finishedGeneration = gen;
+    mtx.unlock();
+}
+
+void ThumbnailLoaderThread::pageDecoded(const Page &p)
+{
+    loaderMutex.lock();
+    if (requests.contains(p.getNumber(), false))
+    {
+        //
+        // downscaling decoded page is cheapest, so it goes before anything else
+        decoded.insert(p.getNumber(), p.getImage());
+        requests.reschedule(p.getNumber(), false, PriorityVisible, 0);
+    }
+    loaderMutex.unlock();
+}
+
+void ThumbnailLoaderThread::pageDecoded(const Page &p1, const Page &p2)
+{
+    pageDecoded(p1);
+    pageDecoded(p2);
+}
+
+void ThumbnailLoaderThread::cancel(int page)
+{
+    LoaderThreadBase::cancel(page);
+    loaderMutex.lock();
+    decoded.remove(page);
+    loaderMutex.unlock();
+}
+
+void ThumbnailLoaderThread::cancelAll()
+{
+    LoaderThreadBase::cancelAll();
+    loaderMutex.lock();
+    decoded.clear();
+    loaderMutex.unlock();
+}
+
+void ThumbnailLoaderThread::setVisibleRange(int first, int last, int direction)
+{
+    loaderMutex.lock();
+    visibleFirst = first;
+    visibleLast = last;
+    scrollDirection = direction;
+    loaderMutex.unlock();
+}
+
+void ThumbnailLoaderThread::schedule(LoadRequest &req)
+{
+    if (decoded.contains(req.pageNumber))
+    {
+        req.priority = PriorityVisible;
+        req.deadline = 0;
+        return;
+    }
+    LoaderThreadBase::schedule(req);
+}
+
+LoadRequest ThumbnailLoaderThread::takeRequest()
+{
+    if (visibleFirst < 0 || requests.first().priority < PriorityThumbnail)
+    {
+        return requests.pop(); // view not shown yet (keep requests order), or decoded page
+    }
+
+    //
+    // nearest queued pages on both sides of visible range start; the one after it may be visible
+    LoadRequest ahead, behind;
+    const bool hasAhead = requests.findAfter(visibleFirst, ahead);
+    const bool hasBehind = requests.findBefore(visibleFirst, behind);
+    if (hasAhead && ahead.pageNumber <= visibleLast)
+    {
+        return requests.take(ahead.pageNumber, ahead.twoPages);
+    }
+    if (!hasBehind)
+    {
+        return requests.take(ahead.pageNumber, ahead.twoPages);
+    }
+    if (!hasAhead)
+    {
+        return requests.take(behind.pageNumber, behind.twoPages);
+    }
+    const int aheadDist = (ahead.pageNumber - visibleLast) * (scrollDirection < 0 ? 2 : 1);
+    const int behindDist = (visibleFirst - behind.pageNumber) * (scrollDirection > 0 ? 2 : 1);
+    const LoadRequest &next = (aheadDist <= behindDist) ? ahead : behind;
+    return requests.take(next.pageNumber, next.twoPages);
+}
+
+void ThumbnailLoaderThread::queueEmpty(const QSharedPointer<ImgSink> &sink)
+{
+    sink->flushThumbnails();
+}
+
 void ThumbnailLoaderThread::setUseCache(bool f)
 {
     mtx.lock();
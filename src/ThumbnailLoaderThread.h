@@ -17,6 +17,11 @@
 
 #include "LoaderThreadBase.h"
 #include <QMutex>
+#include <QMap>
+#include <QImage>
+#include <QList>
+
+class QTimer;
 
 namespace QComicBook
 {
@@ -27,19 +32,58 @@ namespace QComicBook
     Q_OBJECT
             
     signals:
-        void thumbnailLoaded(const Thumbnail &);
+        //! Emited in GUI thread with thumbnails finished since previous emission, at most once per DELIVERY_INTERVAL.
+        void thumbnailsLoaded(const QList<Thumbnail> &);
 
     public:
         ThumbnailLoaderThread(bool cache=false);
         virtual ~ThumbnailLoaderThread();
         virtual void setUseCache(bool f);
+        virtual void setSink(QSharedPointer<ImgSink> sink = QSharedPointer<ImgSink>());
+
+    public slots:
+        //! Takes over thumbnail request of a page that was just decoded elsewhere.
+        /*! If thumbnail of this page is requested, the request is made most urgent and the thumbnail is made by downscaling decoded page. */
+        void pageDecoded(const Page &p);
+        void pageDecoded(const Page &p1, const Page &p2);
+
+        virtual void cancel(int page);
+        virtual void cancelAll();
+
+        //! Makes thumbnails of given pages loaded first, then the ones nearby.
+        /*! Only the range is stored; queued requests are ordered by it when they're taken, see takeRequest().
+         *  @param first first visible page
+         *  @param last last visible page
+         *  @param direction scrolling direction: 1 for forward, -1 for backward, 0 if unknown */
+        void setVisibleRange(int first, int last, int direction);
         
     protected:
-        virtual bool process(const LoadRequest &req);
+        virtual bool process(const LoadRequest &req, const QSharedPointer<ImgSink> &sink);
+        //! Makes thumbnails of decoded pages most urgent.
+        virtual void schedule(LoadRequest &req);
+        //! Takes thumbnail nearest to visible range, unless there is a more urgent request.
+        /*! Pages behind scrolling direction count as twice as far as pages ahead. */
+        virtual LoadRequest takeRequest();
+        virtual void queueEmpty(const QSharedPointer<ImgSink> &sink);
+
+    private slots:
+        void scheduleDelivery();
+        void deliver();
         
     private:
+        //! Queues thumbnail for delivery unless it was made for previous sink.
+        void addFinished(const Thumbnail &t, int generation);
+
+        static const int DELIVERY_INTERVAL; //!< in miliseconds, about one frame
+
         QMutex mtx;
         volatile bool usecache;
+        QMap<int, QImage> decoded; //!< decoded pages for pending requests; guarded by loaderMutex
+        int visibleFirst, visibleLast; //!< visible thumbnails range; guarded by loaderMutex
+        int scrollDirection;
+        QList<Thumbnail> finished; //!< thumbnails waiting for delivery; guarded by mtx
+        int finishedGeneration; //!< sink generation of thumbnails accepted for delivery; guarded by mtx
+        QTimer *deliveryTimer;
     };
 }
 
@@ -0,0 +1,135 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2010 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+#include "ThumbnailsModel.h"
+#include "Thumbnail.h"
+#include <QPainter>
+
+using namespace QComicBook;
+
+const int ThumbnailsModel::ATLAS_COLUMNS = 20;
+const int ThumbnailsModel::ATLAS_ROWS = 16;
+
+ThumbnailsModel::ThumbnailsModel(QObject *parent)
+	: QAbstractListModel(parent)
+	, m_nextSlot(0)
+{
+}
+
+ThumbnailsModel::~ThumbnailsModel()
+{
+}
+
+int ThumbnailsModel::rowCount(const QModelIndex &parent) const
+{
+	return parent.isValid() ? 0 : m_slots.count();
+}
+
+QVariant ThumbnailsModel::data(const QModelIndex &index, int role) const
+{
+	if (index.isValid() && role == Qt::DisplayRole)
+	{
+		return QString::number(index.row() + 1);
+	}
+	return QVariant();
+}
+
+void ThumbnailsModel::setPages(int pages)
+{
+	beginResetModel();
+	m_slots.fill(-1, pages);
+	m_sizes.fill(QSize(), pages);
+	m_atlases.clear();
+	m_nextSlot = 0;
+	endResetModel();
+}
+
+void ThumbnailsModel::clear()
+{
+	setPages(0);
+}
+
+void ThumbnailsModel::setThumbnails(const QList<Thumbnail> &thumbs)
+{
+	int first = m_slots.count();
+	int last = -1;
+	foreach (const Thumbnail &t, thumbs)
+	{
+		if (paintThumbnail(t))
+		{
+			first = qMin(first, t.page());
+			last = qMax(last, t.page());
+		}
+	}
+	if (last >= 0)
+	{
+		emit dataChanged(index(first), index(last));
+	}
+}
+
+bool ThumbnailsModel::paintThumbnail(const Thumbnail &t)
+{
+	const int page = t.page();
+	if (page < 0 || page >= m_slots.count())
+	{
+		return false;
+	}
+
+	int slot = m_slots[page];
+	if (slot < 0)
+	{
+		slot = m_slots[page] = m_nextSlot++;
+	}
+
+	const int atlas = slot / (ATLAS_COLUMNS * ATLAS_ROWS);
+	if (atlas >= m_atlases.count())
+	{
+		//
+		// every page gets one slot, so the last atlas only needs room for the remaining pages
+		const int perAtlas = ATLAS_COLUMNS * ATLAS_ROWS;
+		const int count = qMin(perAtlas, m_slots.count() - atlas * perAtlas);
+		const int columns = qMin(count, ATLAS_COLUMNS);
+		const int rows = (count + ATLAS_COLUMNS - 1) / ATLAS_COLUMNS;
+		QPixmap pix(columns * Thumbnail::maxWidth(), rows * Thumbnail::maxHeight());
+		pix.fill(Qt::white);
+		m_atlases.append(pix);
+	}
+
+	const QImage &img(t.image());
+	QPainter p(&m_atlases[atlas]);
+	p.drawImage(slotPosition(slot), img);
+	m_sizes[page] = img.size().boundedTo(QSize(Thumbnail::maxWidth(), Thumbnail::maxHeight()));
+	return true;
+}
+
+bool ThumbnailsModel::isLoaded(int page) const
+{
+	return page >= 0 && page < m_slots.count() && m_slots[page] >= 0;
+}
+
+bool ThumbnailsModel::thumbnail(int page, const QPixmap *&atlas, QRect &rect) const
+{
+	if (!isLoaded(page))
+	{
+		return false;
+	}
+	const int slot = m_slots[page];
+	atlas = &m_atlases[slot / (ATLAS_COLUMNS * ATLAS_ROWS)];
+	rect = QRect(slotPosition(slot), m_sizes[page]);
+	return true;
+}
+
+QPoint ThumbnailsModel::slotPosition(int slot) const
+{
+	slot %= ATLAS_COLUMNS * ATLAS_ROWS;
+	return QPoint((slot % ATLAS_COLUMNS) * Thumbnail::maxWidth(), (slot / ATLAS_COLUMNS) * Thumbnail::maxHeight());
+}
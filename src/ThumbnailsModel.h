@@ -0,0 +1,68 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2010 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+#ifndef __THUMBNAILSMODEL_H
+#define __THUMBNAILSMODEL_H
+
+#include <QAbstractListModel>
+#include <QVector>
+#include <QList>
+#include <QPixmap>
+#include <QSize>
+
+namespace QComicBook
+{
+	class Thumbnail;
+
+	//! Model of thumbnails of all pages of a comic book.
+	/*! Per-page data is just a slot number and image size; loaded thumbnails are
+	 *  packed into a few large atlas pixmaps, created as they fill up; the last
+	 *  one is only as large as the pages left for it.
+	 */
+	class ThumbnailsModel: public QAbstractListModel
+	{
+		Q_OBJECT
+
+		public:
+			ThumbnailsModel(QObject *parent = 0);
+			virtual ~ThumbnailsModel();
+
+			virtual int rowCount(const QModelIndex &parent = QModelIndex()) const;
+			virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+
+			void setPages(int pages);
+			//! Adds loaded thumbnails and notifies views with single dataChanged() signal.
+			void setThumbnails(const QList<Thumbnail> &thumbs);
+			void clear();
+			bool isLoaded(int page) const;
+
+			//! Locates thumbnail of given page.
+			/*! @param atlas receives atlas containing the thumbnail
+			 *  @param rect receives thumbnail rectangle within atlas
+			 *  @return false if thumbnail is not loaded */
+			bool thumbnail(int page, const QPixmap *&atlas, QRect &rect) const;
+
+		private:
+			QPoint slotPosition(int slot) const;
+			bool paintThumbnail(const Thumbnail &t);
+
+			static const int ATLAS_COLUMNS;
+			static const int ATLAS_ROWS;
+
+			QVector<int> m_slots; //!< atlas slot of every page, -1 if not loaded
+			QVector<QSize> m_sizes; //!< thumbnail size of every page
+			QVector<QPixmap> m_atlases;
+			int m_nextSlot;
+	};
+}
+
+#endif
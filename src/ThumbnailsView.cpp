@@ -11,122 +11,134 @@
  */
 
 #include "ThumbnailsView.h"
-#include "IconViewThumbnail.h"
+#include "ThumbnailsModel.h"
+#include "ThumbnailDelegate.h"
 #include "Thumbnail.h"
-#include <qpixmap.h>
-#include <qstring.h>
-#include <qpainter.h>
-#include <QVector>
 #include <QMenu>
 #include <QContextMenuEvent>
+#include <QScrollBar>
 
 using namespace QComicBook;
 
-ThumbnailsView::ThumbnailsView(QWidget *parent): QListWidget(parent), selected(NULL), numpages(0)
+ThumbnailsView::ThumbnailsView(QWidget *parent): QListView(parent), selected(-1), visibleFirst(-1), visibleLast(-1)
 {
+	model = new ThumbnailsModel(this);
+	setModel(model);
+	setItemDelegate(new ThumbnailDelegate(model, this));
+
 	//setFocusPolicy(QWidget::NoFocus);
 	setDragDropMode(QAbstractItemView::NoDragDrop);
 	setMovement(QListView::Static);
-	//arrangeItemsInGrid(true);
 	setViewMode(QListView::IconMode);
-	setIconSize(QSize(Thumbnail::maxWidth(), Thumbnail::maxHeight()));
 	setResizeMode(QListView::Adjust);
-	//setAutoArrange(true);
-	//setResizeMode(QIconView::Adjust);
-	//setMaxItemWidth(Thumbnail::maxWidth());
+	setUniformItemSizes(true); // layout doesn't query every item
 
 	//
 	// context menu
 	menu = new QMenu(this);
 	menu->addAction(tr("Go to"), this, SLOT(goToPageAction()));
-	
-	//
-	// create "empty page" image
-	emptypage = new QPixmap(Thumbnail::maxWidth(), Thumbnail::maxHeight());
-	emptypage->fill(Qt::white);
-	QPainter paint(emptypage);
-	QPen pen(Qt::black, 3);
-	paint.setPen(pen);
-	paint.drawRect(0, 0, Thumbnail::maxWidth(), Thumbnail::maxHeight());
-
-	connect(this, SIGNAL(itemClicked(QListWidgetItem *)), this, SLOT(onDoubleClick(QListWidgetItem *)));
+
+	connect(this, SIGNAL(clicked(const QModelIndex &)), this, SLOT(onClicked(const QModelIndex &)));
+	connect(verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(updateVisibleRange()));
+	connect(horizontalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(updateVisibleRange()));
 }
 
 ThumbnailsView::~ThumbnailsView()
 {
-	delete emptypage;
 }
 
-void ThumbnailsView::onDoubleClick(QListWidgetItem *item)
+void ThumbnailsView::onClicked(const QModelIndex &index)
 {
-	emit requestedPage(dynamic_cast<ThumbnailItem *>(item)->page(), false);
+	if (index.isValid())
+		emit requestedPage(index.row(), false);
 }
 
 void ThumbnailsView::setPages(int pages)
 {
 	clear();
-
-	icons.resize(numpages = pages);	
-	for (int i=0; i<numpages; i++)
-		icons.insert(i, new IconViewThumbnail(this, i, *emptypage));
-
-	//setArrangement(visibleWidth() > visibleHeight() ? QIconView::LeftToRight : QIconView::TopToBottom);
+	model->setPages(pages);
+	updateVisibleRange();
 }
 
-void ThumbnailsView::setPage(int n, const QPixmap &img)
+void ThumbnailsView::setThumbnails(const QList<Thumbnail> &thumbs)
 {
-	if (n < icons.count())
-	{
-		IconViewThumbnail *th = icons[n];
-		th->setIcon(img);
-		th->setLoaded(true);
-	}
-}
-
-void ThumbnailsView::setPage(const Thumbnail &t)
-{
-	setPage(t.page(), QPixmap::fromImage(t.image()));
+	model->setThumbnails(thumbs);
 }
 
 void ThumbnailsView::clear()
 {
-	QListWidget::clear();
-	icons.clear();
-	numpages = 0;
-	selected = NULL;
+	model->clear();
+	selected = -1;
+	visibleFirst = visibleLast = -1;
 }
 
 void ThumbnailsView::scrollToPage(int n)
 {
-    if (n>=0 && n < icons.count())
+    const QModelIndex idx(model->index(n));
+    if (idx.isValid())
     {
-        IconViewThumbnail *th = icons[n];
-        setCurrentItem(th);
+        setCurrentIndex(idx);
         if (isVisible())
-            scrollToItem(th);
-        //ensureVisible(th->x(), th->y());
+            scrollTo(idx);
     }
 }
 
 void ThumbnailsView::contextMenuEvent(QContextMenuEvent *e)
 {
 	e->accept();
-	QListWidgetItem *cur = itemAt(e->pos());
-	if (cur)
+	const QModelIndex idx(indexAt(e->pos()));
+	if (idx.isValid())
 	{
-		selected = cur;
+		selected = idx.row();
 		menu->popup(e->globalPos());
 	}
 }
 
 void ThumbnailsView::goToPageAction()
 {
-	if (selected)
-		onDoubleClick(selected);
+	if (selected >= 0)
+		emit requestedPage(selected, false);
 }
 
 bool ThumbnailsView::isLoaded(int n) const
 {
-	return (n < icons.count()) ? icons[n]->isLoaded() : false;
+	return model->isLoaded(n);
+}
+
+void ThumbnailsView::resizeEvent(QResizeEvent *e)
+{
+	QListView::resizeEvent(e);
+	updateVisibleRange();
+}
+
+void ThumbnailsView::showEvent(QShowEvent *e)
+{
+	QListView::showEvent(e);
+	updateVisibleRange();
 }
 
+void ThumbnailsView::updateVisibleRange()
+{
+	const int n = model->rowCount();
+	if (!isVisible() || n == 0)
+		return;
+
+	//
+	// items are laid out in page order, so visible ones form a continuous range
+	const QRect r(viewport()->rect());
+	const QModelIndex firstIdx(indexAt(r.topLeft() + QPoint(spacing() + 1, spacing() + 1)));
+	int first = firstIdx.isValid() ? firstIdx.row() : 0;
+	while (first + 1 < n && !visualRect(model->index(first)).intersects(r))
+		++first;
+	int last = first;
+	while (last + 1 < n && visualRect(model->index(last + 1)).intersects(r))
+		++last;
+
+	if (first != visibleFirst || last != visibleLast)
+	{
+		const int direction = (visibleFirst < 0 || first == visibleFirst) ? 0 : (first > visibleFirst ? 1 : -1);
+		visibleFirst = first;
+		visibleLast = last;
+		emit visibleRangeChanged(first, last, direction);
+	}
+}
@@ -13,36 +13,41 @@
 #ifndef __THUMBNAILSVIEW_H
 #define __THUMBNAILSVIEW_H
 
-#include <QListWidget>
-#include <QVector>
-#include <IconViewThumbnail.h>
+#include <QListView>
+#include <QList>
 
-class QPixmap;
 class QMenu;
-class QListWidgetItem;
  
 namespace QComicBook
 {
 	class Thumbnail;
+	class ThumbnailsModel;
 
-	class ThumbnailsView: public QListWidget
+	class ThumbnailsView: public QListView
 	{
 		Q_OBJECT
 
 		private:
-			int numpages;
-			QPixmap *emptypage;
-			QVector<IconViewThumbnail *> icons;
+			ThumbnailsModel *model;
 			QMenu *menu;
-			QListWidgetItem *selected;
+			int selected; //!< page of context menu
+			int visibleFirst, visibleLast; //!< last reported visible range
 
 		signals:
 			void requestedPage(int n, bool force);
+			//! Emited when range of visible thumbnails changes.
+			/*! @param direction 1 if scrolled forward, -1 if backward, 0 otherwise */
+			void visibleRangeChanged(int first, int last, int direction);
 
 		protected slots:
-			void onDoubleClick(QListWidgetItem *item);
+			void onClicked(const QModelIndex &index);
 			void goToPageAction();
 			virtual void contextMenuEvent(QContextMenuEvent *e);
+			void updateVisibleRange();
+
+		protected:
+			virtual void resizeEvent(QResizeEvent *e);
+			virtual void showEvent(QShowEvent *e);
 
 		public:
 			ThumbnailsView(QWidget *parent);
@@ -51,12 +56,10 @@ namespace QComicBook
 
 		public slots:
 			void setPages(int pages);
-			void setPage(int n, const QPixmap &img);
-			void setPage(const Thumbnail &t);
+			void setThumbnails(const QList<Thumbnail> &thumbs);
 			void clear();
 			void scrollToPage(int n);
 	};
 }
 
 #endif
-
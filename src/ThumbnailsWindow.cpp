@@ -32,9 +32,9 @@ ThumbnailsWindow::~ThumbnailsWindow()
 {
 }
 
-void ThumbnailsWindow::setThumbnail(const Thumbnail &t)
+void ThumbnailsWindow::setThumbnails(const QList<Thumbnail> &thumbs)
 {
-    tview->setPage(t);
+    tview->setThumbnails(thumbs);
 }
 
 void ThumbnailsWindow::showEvent(QShowEvent *e)
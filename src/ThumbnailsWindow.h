@@ -15,6 +15,7 @@
 
 #include <QDockWidget>
 #include <QEvent>
+#include <QList>
 
 namespace QComicBook
 {
@@ -40,7 +41,7 @@ namespace QComicBook
         //void onOrientationChanged(Orientation o); -- nie ma w Qt4
         
     public slots:
-        void setThumbnail(const Thumbnail &t);
+        void setThumbnails(const QList<Thumbnail> &thumbs);
         
     public:
         ThumbnailsWindow(QWidget *parent=0);
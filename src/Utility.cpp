@@ -14,6 +14,7 @@
 #include <QCoreApplication>
 #include <QStringList>
 #include <QFileInfo>
+#include <QDir>
 #include <stdlib.h>
 #include <utime.h>
 
@@ -67,3 +68,18 @@ QString Utility::shortenPath(const QString &path, const QString &filler, int max
     }
     return path;
 }
+
+void Utility::removeLeastRecentlyUsed(const QString &path, const QString &filter, qint64 maxSize)
+{
+    QDir dir(path, filter, QDir::Time, QDir::Files|QDir::NoSymLinks); // most recently modified first
+    const QFileInfoList files = dir.entryInfoList();
+    qint64 total = 0;
+    foreach (const QFileInfo &finfo, files)
+    {
+        total += finfo.size();
+        if (total > maxSize)
+        {
+            dir.remove(finfo.fileName());
+        }
+    }
+}
@@ -13,6 +13,8 @@
 #ifndef __MISCUTIL_H
 #define __MISCUTIL_H
 
+#include <QtGlobal>
+
 class QString;
 
 namespace Utility
@@ -20,6 +22,8 @@ namespace Utility
 	QString which(const QString &command); //similiar to shell 'which' command
         void touch(const QString &path);
         QString shortenPath(const QString &path, const QString &filler, int maxlen);
+        //! Removes least recently modified files matching filter until their total size doesn't exceed maxSize.
+        void removeLeastRecentlyUsed(const QString &path, const QString &filter, qint64 maxSize);
 }
 
 #endif
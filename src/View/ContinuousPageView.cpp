@@ -14,6 +14,7 @@
 #include "Utility.h"
 #include "ComicPageImage.h"
 #include "ComicBookSettings.h"
+#include "PrefetchPolicy.h"
 #include <QImage>
 #include <QPixmap>
 #include <QPainter>
@@ -22,6 +23,7 @@
 #include <QScrollBar>
 #include <algorithm>
 #include "../ComicBookDebug.h"
+#include "RedrawScheduler.h"
 
 using namespace QComicBook;
 
@@ -183,6 +185,25 @@ void ContinuousPageView::disposeOrRequestPages()
 
     _DEBUG << "view rect:" << vy1 << "," << vy2;
 
+    //
+    // pages within preload window around visible ones are kept loaded (or requested),
+    // the others are disposed; window is at least one page on each side
+    int firstInView = -1;
+    int lastInView = -1;
+    for (int i=0; i<imgLabel.size(); i++)
+    {
+        if (isInView(m_ypos.startCoordinate(i), m_ypos.endCoordinate(i), vy1, vy2))
+        {
+            if (firstInView < 0)
+                firstInView = i;
+            lastInView = i;
+        }
+    }
+    ComicBookSettings &cfg(ComicBookSettings::instance());
+    const PrefetchPolicy &prefetch(PrefetchPolicy::instance());
+    const int ahead = cfg.preloadPages() ? prefetch.pagesAhead() : 0;
+    const int behind = cfg.preloadPages() ? prefetch.pagesBehind() : 0;
+
     for (int i=0; i<imgLabel.size(); i++)
     {
         ComicPageImage *w = imgLabel[i];
@@ -193,13 +214,12 @@ void ContinuousPageView::disposeOrRequestPages()
         if (isInView(m_ypos.startCoordinate(i), m_ypos.endCoordinate(i), vy1, vy2))
         {
             _DEBUG << "in view:" << w->pageNumber();
-            if (w->isDisposed())
+            if (!w->isLoaded())
             {
-                if (!hasRequest(w->pageNumber()))
-                {
-                    _DEBUG << "requesting" << w->pageNumber();
-                    addRequest(w->pageNumber(), props.twoPagesMode() && w->hasTwoPages());
-                }
+                // pending preload is requested again as visible, so that it jumps ahead of other preloads;
+                // addRequest() ignores requests that are already pending
+                _DEBUG << "requesting" << w->pageNumber();
+                addRequest(w->pageNumber(), props.twoPagesMode() && w->hasTwoPages());
             }
             else
             {
@@ -215,11 +235,11 @@ void ContinuousPageView::disposeOrRequestPages()
         else // page is not visible
         {
             // if page images are still in memory
-            if (!w->isDisposed())
+            if (w->isLoaded())
             {
                 _DEBUG << "not in view & not disposed:" << w->pageNumber();
-                // dispose page only if none of its neighbours are in view
-                if (! ((i>1 && isInView(m_ypos.startCoordinate(i-1), m_ypos.endCoordinate(i-1), vy1, vy2)) || (i<imgLabel.size()-1 && isInView(m_ypos.startCoordinate(i+1), m_ypos.endCoordinate(i+1), vy1, vy2))) )
+                // dispose page only if it's out of preload window
+                if (firstInView < 0 || i < firstInView - qMax(1, behind) || i > lastInView + qMax(1, ahead))
                 {
                     _DEBUG << "disposing" << w->pageNumber();
                     w->dispose();
@@ -229,16 +249,11 @@ void ContinuousPageView::disposeOrRequestPages()
             else
             {
                 _DEBUG << "not in view & disposed:" << w->pageNumber();
-                ComicBookSettings &cfg(ComicBookSettings::instance());
-                // if previous page is visible then preload this one
-                if (i>0 && isInView(m_ypos.startCoordinate(i-1), m_ypos.endCoordinate(i-1), vy1, vy2))
+                // if page is within preload window then preload it
+                if (firstInView >= 0 && i >= firstInView - behind && i <= lastInView + ahead)
                 {
-                    _DEBUG << "previous page visible";
-                    if (cfg.preloadPages())
-                    {
-                        _DEBUG << "preloading" << w->pageNumber();
-                        addRequest(w->pageNumber(), props.twoPagesMode() && w->hasTwoPages());
-                    }
+                    _DEBUG << "preloading" << w->pageNumber();
+                    addRequest(w->pageNumber(), props.twoPagesMode() && w->hasTwoPages(), PriorityPreload);
                 }
                 else
                 {
@@ -324,6 +339,7 @@ void ContinuousPageView::scrollContentsBy(int dx, int dy)
     _DEBUG << "ContinuousPageView::scrollContentsBy y=" << verticalScrollBar()->value();
     PageViewBase::scrollContentsBy(dx, dy);
     disposeOrRequestPages();
+    redrawScheduler()->viewScrolled(); // pages that came close to view may wait for redraw
     
     const int n = currentPage();
     if (n>=0)
@@ -414,7 +430,7 @@ void ContinuousPageView::gotoPage(int n)
         // set m_requestedPage only if page is not loaded already,
         // otherwise it won't be requested and setImage will scroll
         // to wrong page.
-        if (w->isDisposed())
+        if (!w->isLoaded())
         {
             m_requestedPage = n;
         }
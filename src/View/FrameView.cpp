@@ -12,6 +12,7 @@
 
 #include "FrameView.h"
 #include "ComicBookSettings.h"
+#include "PrefetchPolicy.h"
 #include "Page.h"
 #include "ComicFrameImage.h"
 #include <ComicFrameList.h>
@@ -134,11 +135,21 @@ void FrameView::gotoPage(int n)
         emit currentPageChanged(n);
 
         ComicBookSettings &cfg(ComicBookSettings::instance());
-        if (cfg.preloadPages() && n < numOfPages())
+        if (cfg.preloadPages())
         {   
-            ++n;
-            _DEBUG << "preloading" << n;            
-            addRequest(n, false);
+            //
+            // frames are shown one page at a time, so pages are preloaded one by one
+            const PrefetchPolicy &prefetch(PrefetchPolicy::instance());
+            for (int p = n+1; p <= n + prefetch.pagesAhead() && p < numOfPages(); p++)
+            {
+                _DEBUG << "preloading" << p;
+                addRequest(p, false, PriorityPreload);
+            }
+            for (int p = n-1; p >= n - prefetch.pagesBehind() && p >= 0; p--)
+            {
+                _DEBUG << "preloading" << p;
+                addRequest(p, false, PriorityPreload);
+            }
         }
     }
 }
@@ -21,6 +21,8 @@
 #include <limits>
 #include "ImageTransformThread.h"
 #include "Lens.h"
+#include "PrefetchPolicy.h"
+#include "RedrawScheduler.h"
 #include "../ComicBookDebug.h"
 
 using namespace QComicBook;
@@ -43,6 +45,7 @@ PageViewBase::PageViewBase(QWidget *parent, int physicalPages, const ViewPropert
 
     scene = new QGraphicsScene(this);
     setScene(scene);
+    m_redraws = new RedrawScheduler(this);
    
 //    setAlignment(Qt::AlignHCenter);
     connect(ImageTransformThread::get(), SIGNAL(jobCompleted(const ImageJobResult &)), this, SLOT(jobCompleted(const ImageJobResult &)));
@@ -51,10 +54,22 @@ PageViewBase::PageViewBase(QWidget *parent, int physicalPages, const ViewPropert
 
 PageViewBase::~PageViewBase()
 {
+    delete scene; // images unregister from m_redraws when deleted, so they must go first
     delete smallcursor;
     ImageTransformThread::get()->cancel();
 }
 
+RedrawScheduler* PageViewBase::redrawScheduler() const
+{
+    return m_redraws;
+}
+
+QRectF PageViewBase::redrawArea() const
+{
+    const QRectF visible(mapToScene(viewport()->rect()).boundingRect());
+    return visible.adjusted(0.0, -visible.height(), 0.0, visible.height());
+}
+
 void PageViewBase::setLensZoom(double ratio)
 {
     if (lens)
@@ -384,6 +399,11 @@ void PageViewBase::showPageNumbers(bool f)
     props.setPageNumbers(f);
 }
 
+void PageViewBase::setScalingQuality(ScalingQuality q)
+{
+    props.setScalingQuality(q);
+}
+
 void PageViewBase::enableScrollbars(bool f)
 {
         const Qt::ScrollBarPolicy s = f ? Qt::ScrollBarAsNeeded : Qt::ScrollBarAlwaysOff;
@@ -403,24 +423,29 @@ ViewProperties& PageViewBase::properties()
 
 bool PageViewBase::hasRequest(int page) const
 {
-    return m_requestedPages.indexOf(page) >= 0;
+    return m_requestedPages.contains(page);
 }
 
-void PageViewBase::addRequest(int page, bool twoPages)
+void PageViewBase::addRequest(int page, bool twoPages, int priority)
 {
-    m_requestedPages.append(page);
+    //
+    // pending request is sent again only to raise its priority, e.g. when preloaded page comes into view
+    QHash<int, int>::const_iterator it = m_requestedPages.constFind(page);
+    if (it != m_requestedPages.constEnd() && it.value() <= priority)
+    {
+        return;
+    }
+    m_requestedPages.insert(page, priority);
     if (twoPages)
-        emit requestTwoPages(page);
+        emit requestTwoPages(page, priority);
     else
-        emit requestPage(page);
+        emit requestPage(page, priority);
 }
 
 void PageViewBase::delRequest(int page, bool twoPages, bool cancel)
 {
-    int idx = m_requestedPages.indexOf(page);
-    if (idx >= 0)
+    if (m_requestedPages.remove(page) > 0)
     {
-        m_requestedPages.removeAt(idx);
         if (cancel)
         {
             if (twoPages)
@@ -466,6 +491,26 @@ int PageViewBase::roundPageNumber(int page) const
     return props.twoPagesMode() ? page - (page&1) : page;
 }
 
+void PageViewBase::preloadAround(int page)
+{
+    const PrefetchPolicy &prefetch(PrefetchPolicy::instance());
+    const int ahead = prefetch.pagesAhead();
+    const int behind = prefetch.pagesBehind();
+
+    int n = page;
+    for (int i=0; i<ahead && (n = nextPage(n)) >= 0; i++)
+    {
+        _DEBUG << "preloading" << n;
+        addRequest(n, props.twoPagesMode() && n+1 < numOfPages(), PriorityPreload); // request two pages if not last page
+    }
+    n = page;
+    for (int i=0; i<behind && (n = previousPage(n)) >= 0; i++)
+    {
+        _DEBUG << "preloading" << n;
+        addRequest(n, props.twoPagesMode() && n+1 < numOfPages(), PriorityPreload);
+    }
+}
+
 void PageViewBase::delRequests()
 {
     m_requestedPages.clear();
@@ -501,9 +546,10 @@ void PageViewBase::updateSceneRect()
     //
     // find items bounding rect, but skip lens item if present.
     // this is the same QGraphicsScene::itemsBoundingRect(), except for it skips lens. 
+    // pages of spreads are child items within bounds of the spread and are skipped too.
     foreach (QGraphicsItem *it, items())
     {
-        if (it != lens)
+        if (it != lens && it->parentItem() == 0)
         {
             const QRectF itbr(it->boundingRect());
                   
@@ -14,8 +14,10 @@
 #define __PAGEVIEWBASE_H
 
 #include <QGraphicsView>
+#include <QHash>
 #include "ViewProperties.h"
 #include <ComicFrame.h>
+#include <LoadRequest.h>
 
 class QMenu;
 class QGraphicsScene;
@@ -27,6 +29,7 @@ namespace QComicBook
     class Lens;
     class ComicImage;
     class ImageJobResult;
+    class RedrawScheduler;
 
 	enum Scaling { Smooth, Fast };
 
@@ -39,8 +42,8 @@ namespace QComicBook
             void bottomReached();
             void topReached();
             void doubleClick();
-            void requestPage(int);
-            void requestTwoPages(int);
+            void requestPage(int page, int priority);
+            void requestTwoPages(int page, int priority);
             void cancelPageRequest(int);
             void cancelTwoPagesRequest(int);
             void pageReady(const Page&);
@@ -65,6 +68,7 @@ namespace QComicBook
             virtual void setBackground(const QColor &color);
             virtual void setSmallCursor(bool f);
             virtual void showPageNumbers(bool f);
+            virtual void setScalingQuality(ScalingQuality q);
             virtual void setRotation(Rotation r);
             virtual void rotateRight();
             virtual void rotateLeft();
@@ -102,6 +106,11 @@ namespace QComicBook
             virtual int previousPage(int page) const;
             virtual int roundPageNumber(int page) const;
 
+            RedrawScheduler* redrawScheduler() const;
+            //! Area of the scene where images are redrawn as soon as they change.
+            /*! Visible area extended by one viewport on each side. */
+            QRectF redrawArea() const;
+
         protected:
             virtual void resizeEvent(QResizeEvent *e);
             virtual void contextMenuEvent(QContextMenuEvent *e);
@@ -115,10 +124,16 @@ namespace QComicBook
             void updateSceneRect();
 
             bool hasRequest(int page) const;
-            void addRequest(int page, bool twoPages);
+            //! Requests page from loader.
+            /*! Page that is already requested is requested again, so that the loader can raise its priority.
+             *  @param priority one of LoadPriority */
+            void addRequest(int page, bool twoPages, int priority=PriorityVisible);
             void delRequest(int page, bool twoPages, bool cancel=true);
             void delRequests();
 
+            //! Preloads pages around given one as advised by PrefetchPolicy.
+            void preloadAround(int page);
+
             ViewProperties props;
             QGraphicsScene *scene;
 
@@ -131,7 +146,8 @@ namespace QComicBook
             int wheelupcnt, wheeldowncnt;
             QCursor *smallcursor;
             Lens *lens;
-            QList<int> m_requestedPages;
+            RedrawScheduler *m_redraws;
+            QHash<int, int> m_requestedPages; //!< priority of pending requests by page
         };
 }
 
@@ -0,0 +1,109 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2011 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+#include "RedrawScheduler.h"
+#include "PageViewBase.h"
+#include "../ComicImage.h"
+#include "../ComicBookDebug.h"
+#include <QTimer>
+
+using namespace QComicBook;
+
+const int RedrawScheduler::IDLE_DELAY = 80;
+const int RedrawScheduler::MAX_DELAY = 250;
+
+RedrawScheduler::RedrawScheduler(PageViewBase *view)
+    : QObject(view)
+    , m_view(view)
+{
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    connect(m_timer, SIGNAL(timeout()), this, SLOT(redrawVisible()));
+}
+
+RedrawScheduler::~RedrawScheduler()
+{
+}
+
+void RedrawScheduler::schedule(ComicImage *img)
+{
+    m_pending.insert(img);
+    if (m_view->properties().scalingQuality() == FastScaling)
+    {
+        //
+        // preview is as good as the result, nothing to wait for
+        if (!m_timer->isActive())
+        {
+            m_timer->start(0);
+        }
+        return;
+    }
+    postpone();
+}
+
+void RedrawScheduler::postpone()
+{
+    if (!m_burst.isValid())
+    {
+        m_burst.start();
+    }
+    if (m_burst.elapsed() < MAX_DELAY)
+    {
+        m_timer->start(IDLE_DELAY);
+    }
+    else if (!m_timer->isActive())
+    {
+        m_timer->start(0);
+    }
+}
+
+void RedrawScheduler::remove(ComicImage *img)
+{
+    m_pending.remove(img);
+}
+
+bool RedrawScheduler::isPending(const ComicImage *img) const
+{
+    return m_pending.contains(const_cast<ComicImage *>(img));
+}
+
+void RedrawScheduler::viewScrolled()
+{
+    if (!m_pending.isEmpty())
+    {
+        postpone();
+    }
+}
+
+void RedrawScheduler::redrawVisible()
+{
+    m_timer->stop();
+    m_burst.invalidate();
+
+    const QRectF area(m_view->redrawArea());
+    int n = 0;
+    for (QSet<ComicImage *>::iterator it = m_pending.begin(); it != m_pending.end(); )
+    {
+        ComicImage *img = *it;
+        if (img->scene() == 0 || img->sceneBoundingRect().intersects(area)) // images outside of scene are pre-rendered for view
+        {
+            it = m_pending.erase(it);
+            img->requestRedraw();
+            ++n;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    _DEBUG << "redrawn" << n << "images," << m_pending.count() << "left pending";
+}
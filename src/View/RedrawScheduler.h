@@ -0,0 +1,72 @@
+/*
+ * This file is a part of QComicBook.
+ *
+ * Copyright (C) 2005-2011 Pawel Stolowski <stolowski@gmail.com>
+ *
+ * QComicBook is free software; you can redestribute it and/or modify it
+ * under terms of GNU General Public License by Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY. See GPL for more details.
+ */
+
+#ifndef __REDRAWSCHEDULER_H
+#define __REDRAWSCHEDULER_H
+
+#include <QObject>
+#include <QSet>
+#include <QElapsedTimer>
+
+class QTimer;
+
+namespace QComicBook
+{
+    class PageViewBase;
+    class ComicImage;
+
+    //! Decides when images of a view are redrawn.
+    /*! Images whose size or properties changed are marked pending and show a cheap preview
+     *  (see ComicImage::paintPreview()). Smooth redraws start once changes, scrolling included,
+     *  stop for a moment, so that they don't add latency while user is scrolling or resizing.
+     *  Only pending images near the visible area are redrawn; the others wait until view
+     *  is scrolled close to them. Images that aren't in the scene are pre-rendered pages
+     *  and are redrawn together with visible ones.
+     */
+    class RedrawScheduler: public QObject
+    {
+        Q_OBJECT
+
+    public:
+        RedrawScheduler(PageViewBase *view);
+        virtual ~RedrawScheduler();
+
+        //! Marks image as needing redraw.
+        void schedule(ComicImage *img);
+
+        //! Forgets image; called when image is disposed or deleted.
+        void remove(ComicImage *img);
+
+        bool isPending(const ComicImage *img) const;
+
+        //! Postpones redraws until scrolling stops; pending images that came close to view are redrawn then.
+        void viewScrolled();
+
+    public slots:
+        //! Starts redraws of pending images near visible area.
+        void redrawVisible();
+
+    private:
+        //! Starts redraws after IDLE_DELAY unless changes have been postponing them for MAX_DELAY.
+        void postpone();
+
+        static const int IDLE_DELAY; //!< ms without changes before smooth redraws start
+        static const int MAX_DELAY; //!< redraws start after that long even if changes keep coming
+
+        PageViewBase *m_view;
+        QTimer *m_timer;
+        QSet<ComicImage *> m_pending;
+        QElapsedTimer m_burst; //!< started by first change since last redraw
+    };
+}
+
+#endif
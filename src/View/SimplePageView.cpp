@@ -25,6 +25,15 @@
 
 using namespace QComicBook;
 
+namespace
+{
+    //! Tells if pages are the same decoded image; page reloaded from disk is a new image.
+    bool isSameImage(const Page &a, const Page &b)
+    {
+        return a.getNumber() == b.getNumber() && a.getImage().cacheKey() == b.getImage().cacheKey();
+    }
+}
+
 const int SimplePageView::EXTRA_WHEEL_SPIN = 3;
 
 SimplePageView::SimplePageView(QWidget *parent, int physicalPages, const ViewProperties& props)
@@ -44,6 +53,7 @@ SimplePageView::SimplePageView(QWidget *parent, int physicalPages, const ViewPro
 SimplePageView::~SimplePageView()
 {
     _DEBUG;
+    qDeleteAll(m_prerendered);
 }
 
 void SimplePageView::recreateComicPageImage()
@@ -52,6 +62,8 @@ void SimplePageView::recreateComicPageImage()
 
     delete imgLabel;
     imgLabel = NULL;
+    qDeleteAll(m_prerendered);
+    m_prerendered.clear();
 
     // size of default empty page widget (until first image is loaded)
     int w = viewport()->width() - 10;
@@ -80,6 +92,11 @@ void SimplePageView::propsChanged()
             recreateComicPageImage();
         }
         imgLabel->redrawImages();
+        dropPrerendered();
+        foreach (ComicPageImage *p, m_prerendered)
+        {
+            p->redrawImages();
+        }
         update();
         gotoPage(m_currentPage);
     }
@@ -91,8 +108,18 @@ void SimplePageView::jobCompleted(const ImageJobResult &result)
     _DEBUG;
     if (imgLabel)
     {
-        imgLabel->jobCompleted(result);
-        updateSceneRect();
+        if (imgLabel->jobCompleted(result))
+        {
+            updateSceneRect();
+            return;
+        }
+        foreach (ComicPageImage *p, m_prerendered)
+        {
+            if (p->jobCompleted(result))
+            {
+                break;
+            }
+        }
     }
 }
 
@@ -108,13 +135,22 @@ void SimplePageView::setImage(const Page &img1)
     delRequest(img1.getNumber(), false, false);
     if (img1.getNumber() == m_currentPage)
     {
-        imgLabel->setImage(img1);
-        center(imgLabel);
-        updateSceneRect();
-        horizontalScrollBar()->triggerAction(QAbstractSlider::SliderToMinimum);
-        verticalScrollBar()->triggerAction(QAbstractSlider::SliderToMinimum);
+        if (!holds(imgLabel, img1)) // unless shown already by showPrerendered()
+        {
+            imgLabel->setImage(img1);
+            center(imgLabel);
+            updateSceneRect();
+            horizontalScrollBar()->triggerAction(QAbstractSlider::SliderToMinimum);
+            verticalScrollBar()->triggerAction(QAbstractSlider::SliderToMinimum);
+        }
         emit pageReady(img1);
     }
+    else if (isNeighbour(img1.getNumber()) && !isSpread(img1.getNumber()))
+    {
+        ComicPageImage *p = new ComicPageImage(this, imgLabel->width(), imgLabel->height(), img1.getNumber());
+        p->setImage(img1);
+        addPrerendered(p);
+    }
 }
 
 void SimplePageView::setImage(const Page &img1, const Page &img2)
@@ -124,13 +160,100 @@ void SimplePageView::setImage(const Page &img1, const Page &img2)
     delRequest(img1.getNumber(), true, false);
     if (img1.getNumber() == m_currentPage)
     {
-        imgLabel->setImage(img1, img2);
-        center(imgLabel);
-        updateSceneRect();
-        horizontalScrollBar()->triggerAction(QAbstractSlider::SliderToMinimum);
-        verticalScrollBar()->triggerAction(QAbstractSlider::SliderToMinimum);
+        if (!holds(imgLabel, img1, img2))
+        {
+            imgLabel->setImage(img1, img2);
+            center(imgLabel);
+            updateSceneRect();
+            horizontalScrollBar()->triggerAction(QAbstractSlider::SliderToMinimum);
+            verticalScrollBar()->triggerAction(QAbstractSlider::SliderToMinimum);
+        }
         emit pageReady(img1, img2);
     }
+    else if (isNeighbour(img1.getNumber()) && isSpread(img1.getNumber()))
+    {
+        ComicPageImage *p = new ComicPageImage(this, imgLabel->width(), imgLabel->height(), img1.getNumber(), true);
+        p->setImage(img1, img2);
+        addPrerendered(p);
+    }
+}
+
+bool SimplePageView::isSpread(int page) const
+{
+    return props.twoPagesMode() && page+1 < numOfPages();
+}
+
+bool SimplePageView::isNeighbour(int page) const
+{
+    return page == nextPage(m_currentPage) || page == previousPage(m_currentPage);
+}
+
+bool SimplePageView::holds(ComicPageImage *img, int page, bool twoPages)
+{
+    return img && img->numOfPages() == (twoPages ? 2 : 1) && img->getPage(0).getNumber() == page;
+}
+
+bool SimplePageView::holds(ComicPageImage *img, const Page &img1)
+{
+    return holds(img, img1.getNumber(), false) && isSameImage(img->getPage(0), img1);
+}
+
+bool SimplePageView::holds(ComicPageImage *img, const Page &img1, const Page &img2)
+{
+    return holds(img, img1.getNumber(), true) && isSameImage(img->getPage(0), img1) && isSameImage(img->getPage(1), img2);
+}
+
+void SimplePageView::showPrerendered(ComicPageImage *img)
+{
+    _DEBUG << "showing pre-rendered page" << m_currentPage;
+    scene->removeItem(imgLabel);
+    if (imgLabel->numOfPages() > 0)
+    {
+        m_prerendered.append(imgLabel); // kept if user goes back
+    }
+    else
+    {
+        delete imgLabel;
+    }
+    imgLabel = img;
+    scene->addItem(imgLabel);
+    center(imgLabel);
+    updateSceneRect();
+    horizontalScrollBar()->triggerAction(QAbstractSlider::SliderToMinimum);
+    verticalScrollBar()->triggerAction(QAbstractSlider::SliderToMinimum);
+}
+
+void SimplePageView::addPrerendered(ComicPageImage *img)
+{
+    const int page = img->getPage(0).getNumber();
+    delete takePrerendered(page, img->hasTwoPages());
+    m_prerendered.append(img);
+    _DEBUG << "pre-rendering page" << page;
+}
+
+ComicPageImage* SimplePageView::takePrerendered(int page, bool twoPages)
+{
+    for (int i=0; i<m_prerendered.count(); i++)
+    {
+        if (holds(m_prerendered[i], page, twoPages))
+        {
+            return m_prerendered.takeAt(i);
+        }
+    }
+    return NULL;
+}
+
+void SimplePageView::dropPrerendered()
+{
+    for (int i=m_prerendered.count()-1; i>=0; i--)
+    {
+        ComicPageImage *p = m_prerendered[i];
+        const int page = p->numOfPages() > 0 ? p->getPage(0).getNumber() : -1;
+        if (!isNeighbour(page) || p->hasTwoPages() != isSpread(page))
+        {
+            delete m_prerendered.takeAt(i);
+        }
+    }
 }
 
 void SimplePageView::gotoPage(int n)
@@ -144,15 +267,25 @@ void SimplePageView::gotoPage(int n)
         }
         m_currentPage = n = roundPageNumber(n);
 
+        //
+        // page turn to pre-rendered page only swaps images; loader still delivers the page, see setImage()
+        if (!holds(imgLabel, n, isSpread(n)))
+        {
+            ComicPageImage *ready = takePrerendered(n, isSpread(n));
+            if (ready)
+            {
+                showPrerendered(ready);
+            }
+        }
+        dropPrerendered();
+
         addRequest(m_currentPage, props.twoPagesMode() && n+1 < numOfPages());
         emit currentPageChanged(n);
 
         ComicBookSettings &cfg(ComicBookSettings::instance());
         if (cfg.preloadPages())
         {   
-            n = nextPage(n);
-            _DEBUG << "preloading" << n;            
-            addRequest(n, props.twoPagesMode() && n < numOfPages()); // request two pages if not last page
+            preloadAround(n);
         }
     }
 }
@@ -163,6 +296,10 @@ void SimplePageView::resizeEvent(QResizeEvent *e)
     {
         imgLabel->recalcScaledSize();
     }
+    foreach (ComicPageImage *p, m_prerendered)
+    {
+        p->recalcScaledSize();
+    }
     PageViewBase::resizeEvent(e);
 }
 
@@ -29,6 +29,21 @@ namespace QComicBook
            
         protected:
             void recreateComicPageImage();
+            //! Tells if page is shown together with the next one in current mode.
+            bool isSpread(int page) const;
+            bool isNeighbour(int page) const;
+            //! Tells if image holds given page (or spread starting with it).
+            static bool holds(ComicPageImage *img, int page, bool twoPages);
+            //! Tells if image holds exactly given decoded page(s), not just the same page numbers.
+            static bool holds(ComicPageImage *img, const Page &img1);
+            static bool holds(ComicPageImage *img, const Page &img1, const Page &img2);
+            //! Shows pre-rendered image in place of the current one.
+            void showPrerendered(ComicPageImage *img);
+            //! Keeps image of page next to the current one; it's rendered at view size in background.
+            void addPrerendered(ComicPageImage *img);
+            ComicPageImage* takePrerendered(int page, bool twoPages);
+            //! Deletes pre-rendered images of pages that aren't next to the current one.
+            void dropPrerendered();
             virtual void resizeEvent(QResizeEvent *e);
             virtual void wheelEvent(QWheelEvent *e);
             virtual void scrollContentsBy(int dx, int dy);
@@ -59,6 +74,7 @@ namespace QComicBook
             static const int EXTRA_WHEEL_SPIN; //number of extra wheel spins to flip the page
             static const float JUMP_FACTOR; //factor used to calculate the amount of space to scroll when scrolling page with space
             ComicPageImage* imgLabel;
+            QList<ComicPageImage *> m_prerendered; //!< next and previous pages; not in scene
             int m_currentPage;
 	};
 }
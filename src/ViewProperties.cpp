@@ -35,7 +35,7 @@ void ViewProperties::setFromSettings()
     m_data.twoPagesMode = cfg.twoPagesMode();
     m_data.mangaMode = cfg.japaneseMode();
     m_data.background = cfg.background();
-    m_data.smoothScaling = cfg.smoothScaling();
+    m_data.scaling = cfg.scalingQuality();
 }
 
 int ViewProperties::angle() const
@@ -137,6 +137,20 @@ bool ViewProperties::mangaMode() const
     return m_data.mangaMode;
 }
 
+ScalingQuality ViewProperties::scalingQuality() const
+{
+    return m_data.scaling;
+}
+
+void ViewProperties::setScalingQuality(ScalingQuality q)
+{
+    if (m_data.scaling != q)
+    {
+        m_data.scaling = q;
+        emit changed();
+    }
+}
+
 const ViewPropertiesData& ViewProperties::getProperties() const
 {
     return m_data;
@@ -45,6 +45,9 @@ namespace QComicBook
         bool twoPagesMode() const;
         void setMangaMode(bool f);
         bool mangaMode() const;
+        //! Scaling quality; chooses between QPainter and Resampler methods.
+        ScalingQuality scalingQuality() const;
+        void setScalingQuality(ScalingQuality q);
         const ViewPropertiesData& getProperties() const;
 
     private:
@@ -19,6 +19,7 @@ namespace QComicBook
 {
     enum Size { Original, FitWidth, FitHeight, WholePage, BestFit };
     enum Rotation { None, Left, Right };
+    enum ScalingQuality { FastScaling, SmoothScaling, BestScaling };
 
     struct ViewPropertiesData
     {
@@ -30,7 +31,7 @@ namespace QComicBook
         bool twoPagesMode;
         bool mangaMode;
         bool contScroll;
-        bool smoothScaling;
+        ScalingQuality scaling;
     };
 }
 